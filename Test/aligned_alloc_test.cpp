@@ -0,0 +1,58 @@
+#include "../stl_aligned_alloc.h"
+#include "../vector.h"
+#include "../deque.h"
+#include "../list.h"
+#include <iostream>
+using namespace std;
+
+// 每个线程一个计数器, 按缓存行对齐避免伪共享
+struct alignas(64) counter
+{
+    long value;
+};
+
+template <typename T>
+bool aligned(const T * p, size_t align)
+{
+    return ((size_t)p & (align-1)) == 0;
+}
+
+int main()
+{
+    // 显式指定32字节对齐, 供AVX使用
+    ltx::vector<float, ltx::align_alloc<32> > v;
+    for(int i=0; i<1000; ++i) v.push_back(i*0.5f);
+    cout << "vector<float> 32 aligned: " << aligned(&v[0], 32) << " " << v[999] << endl;
+
+    // 对齐跟随alignof(T)
+    ltx::vector<counter, ltx::align_alloc<> > counters(8, counter());
+    bool ok = true;
+    for(size_t i=0; i<counters.size(); ++i) ok = ok && aligned(&counters[i], 64);
+    cout << "vector<counter> 64 aligned: " << ok << endl;
+
+    ltx::deque<counter, ltx::align_alloc<> > d;
+    for(int i=0; i<100; ++i)
+    {
+        counter c = {i};
+        if(i%2) d.push_back(c);
+        else d.push_front(c);
+    }
+    ok = true;
+    for(size_t i=0; i<d.size(); ++i) ok = ok && aligned(&d[i], 64);
+    cout << "deque<counter> 64 aligned: " << ok << " " << d.front().value << " " << d.back().value << endl;
+
+    // 缓存行对齐的配置器
+    ltx::deque<int, ltx::cache_aligned_alloc> di;
+    for(int i=0; i<1000; ++i) di.push_back(i);
+    cout << "deque<int> first block 64 aligned: " << aligned(&di[0], 64) << " " << di[999] << endl;
+
+    // 对齐不超过8字节时和default_alloc相同
+    ltx::list<int, ltx::align_alloc<> > l;
+    for(int i=0; i<10; ++i) l.push_back(i);
+    cout << "list: " << l.front() << " " << l.back() << endl;
+
+    void * p = ltx::align_alloc<>::allocate(100, 256);
+    cout << "raw 256 aligned: " << aligned((char*)p, 256) << endl;
+    ltx::align_alloc<>::deallocate(p, 100, 256);
+    return 0;
+}
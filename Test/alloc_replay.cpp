@@ -0,0 +1,66 @@
+// 配置记录与重放
+// 不带参数运行时, 先记录一段使用容器的负载到alloc_trace.bin, 再在各个配置器上重放
+// 带参数运行时, 重放指定的记录文件(例如生产环境中以LTX_ALLOC_TRACE编译的程序写出的文件)
+#define LTX_ALLOC_TRACE
+#include "../stl_alloc.h"
+#include "../stl_thread_alloc.h"
+#include "../stl_lockfree_alloc.h"
+#include "../vector.h"
+#include "../list.h"
+#include "../map.h"
+#include <iostream>
+#include <thread>
+using namespace std;
+
+static_assert(sizeof(ltx::alloc_trace_record) == 32, "trace record layout");
+
+// thread_local的v先于记录缓冲区构造, 线程退出时在缓冲区析构之后释放, 这次释放不再记录
+void exit_workload()
+{
+    static thread_local ltx::vector<int> v;
+    for(int i=0; i<100; ++i) v.push_back(i);
+}
+
+void workload()
+{
+    ltx::list<ltx::vector<int> > l;
+    for(int i=0; i<20000; ++i)
+    {
+        ltx::vector<int> v;
+        for(int j=0; j<i%50; ++j) v.push_back(j);
+        l.push_back(v);
+        if(i%3 == 0) l.pop_front();
+    }
+    ltx::map<int, int> m;
+    for(int i=0; i<2000; ++i) m[i*7919%2000] = i;
+}
+
+int main(int argc, char * argv[])
+{
+    const char * path = "alloc_trace.bin";
+    if(argc > 1) path = argv[1];
+    else
+    {
+        ltx::alloc_trace::open(path);
+        workload();
+        std::thread(exit_workload).join();
+        ltx::alloc_trace::stop();
+    }
+
+    vector<ltx::replay_op> ops;
+    size_t nslots;
+    if(!ltx::load_trace(path, ops, nslots))
+    {
+        cout << "cannot read " << path << endl;
+        return 1;
+    }
+    size_t allocs = 0;
+    for(size_t i=0; i<ops.size(); ++i) if(ops[i].op == ltx::__TRACE_ALLOC) ++allocs;
+    cout << "ops: " << ops.size() << ", allocations: " << allocs << ", max live: " << nslots << endl;
+
+    cout << "base_alloc: " << ltx::replay_trace<ltx::base_alloc>(ops, nslots)/ops.size() << " ns/op" << endl;
+    cout << "default_alloc: " << ltx::replay_trace<ltx::default_alloc>(ops, nslots)/ops.size() << " ns/op" << endl;
+    cout << "thread_alloc: " << ltx::replay_trace<ltx::thread_alloc>(ops, nslots)/ops.size() << " ns/op" << endl;
+    cout << "lockfree_alloc: " << ltx::replay_trace<ltx::lockfree_alloc>(ops, nslots)/ops.size() << " ns/op" << endl;
+    return 0;
+}
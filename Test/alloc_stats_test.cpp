@@ -0,0 +1,56 @@
+#define LTX_ALLOC_STATS
+#include "../list.h"
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+using namespace std;
+
+// fail_new为true时operator new抛出bad_alloc
+static bool fail_new = false;
+void * operator new(size_t n)
+{
+    if(fail_new) throw std::bad_alloc();
+    void * p = std::malloc(n != 0 ? n : 1);
+    if(p == nullptr) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void * p) noexcept { std::free(p); }
+
+int main()
+{
+    ltx::list<int> l;
+    for(int i=0; i<100; ++i) l.push_back(i);
+    void * big = ltx::default_alloc::allocate(1000);
+
+    ltx::alloc_stats s = ltx::default_alloc::stats();
+    cout << "heap_size: " << s.heap_size << endl;
+    cout << "pool_bytes: " << s.pool_bytes << endl;
+    cout << "in use: " << s.bytes_in_use << " high water: " << s.high_water << endl;
+    cout << "24 bytes: alloc " << s.classes[2].allocations
+         << " refills " << s.classes[2].refills
+         << " free " << s.classes[2].free_blocks << endl;
+
+    ltx::default_alloc::deallocate(big, 1000);
+    ltx::default_alloc::stats().dump_json(cout);
+    cout << endl;
+
+    // 配置失败时不计入统计
+    ltx::alloc_stats before = ltx::default_alloc::stats();
+    fail_new = true;
+    bool thrown = false;
+    try { ltx::default_alloc::allocate(ltx::__MAX_BYTES + 1); } catch(const std::bad_alloc&) { thrown = true; }
+    assert(thrown);
+    // 切完内存池中剩余的空间后refill失败
+    size_t got = 0;
+    const size_t n = 128;
+    thrown = false;
+    try { for(;;) { ltx::default_alloc::allocate(n); ++got; } } catch(const std::bad_alloc&) { thrown = true; }
+    fail_new = false;
+    ltx::alloc_stats after = ltx::default_alloc::stats();
+    assert(thrown);
+    assert(after.large_allocations == before.large_allocations);
+    assert(after.bytes_in_use == before.bytes_in_use + got*n);
+    cout << "failed allocations not counted, " << got << " blocks before bad_alloc" << endl;
+    return 0;
+}
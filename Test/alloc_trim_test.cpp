@@ -0,0 +1,34 @@
+#include "../stl_alloc.h"
+#include <iostream>
+#include <vector>
+using namespace std;
+
+int main()
+{
+    // 一次突发配置大量区块
+    vector<void*> blocks;
+    for(int i=0; i<100000; ++i)
+        blocks.push_back(ltx::default_alloc::allocate(8*(i%16+1)));
+    cout << "peak heap_size: " << ltx::default_alloc::stats().heap_size << endl;
+
+    // 还有区块在使用的大块不能归还
+    void * keep = ltx::default_alloc::allocate(32);
+    for(int i=0; i<100000; ++i)
+        ltx::default_alloc::deallocate(blocks[i], 8*(i%16+1));
+    cout << "released: " << ltx::default_alloc::trim() << endl;
+    cout << "heap_size after trim: " << ltx::default_alloc::stats().heap_size << endl;
+
+    ltx::default_alloc::deallocate(keep, 32);
+    cout << "released: " << ltx::default_alloc::trim() << endl;
+    cout << "heap_size after trim: " << ltx::default_alloc::stats().heap_size << endl;
+
+    // 归还后仍能正常配置
+    ltx::default_alloc::set_trim_interval(1000);
+    for(int round=0; round<3; ++round)
+    {
+        for(int i=0; i<10000; ++i) blocks[i] = ltx::default_alloc::allocate(24);
+        for(int i=0; i<10000; ++i) ltx::default_alloc::deallocate(blocks[i], 24);
+        cout << "round " << round << " heap_size: " << ltx::default_alloc::stats().heap_size << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include "../stl_arena_alloc.h"
+#include "../vector.h"
+#include "../list.h"
+#include "../deque.h"
+#include "../set.h"
+#include "../map.h"
+#include <iostream>
+using namespace std;
+
+typedef ltx::arena_alloc<1> request_arena;
+
+// 模拟一次请求: 构建一些临时容器, 然后整体丢弃
+void handle_request(int n)
+{
+    ltx::vector<int, request_arena> v;
+    ltx::list<int, request_arena> l;
+    ltx::deque<int, request_arena> d;
+    ltx::set<int, less<int>, request_arena> s;
+    ltx::map<int, int, less<int>, request_arena> m;
+    for(int i=0; i<n; ++i)
+    {
+        v.push_back(i);
+        l.push_back(i);
+        d.push_back(i);
+        s.insert(i*7%n);
+        m[i*3%n] = i;
+    }
+    cout << v[n-1] << " " << l.back() << " " << d[n-1] << " "
+         << s.size() << " " << m.size() << endl;
+}
+
+int main()
+{
+    for(int round=0; round<3; ++round)
+    {
+        handle_request(1000);
+        cout << "arena bytes: " << request_arena::bytes_used() << endl;
+        request_arena::reset();
+    }
+    request_arena::release();
+    cout << "after release: " << request_arena::bytes_used() << endl;
+    return 0;
+}
@@ -0,0 +1,79 @@
+// vector<bool>: 每个元素占一位, count/find_first/flip/&=/|=按字进行
+// 和逐字节存放的vector<char>比较占用的空间和统计1的个数的耗时
+#include "../vector.h"
+#include <iostream>
+#include <chrono>
+#include <cassert>
+using namespace std;
+
+void print(const ltx::vector<bool>& v)
+{
+    for(ltx::vector<bool>::const_iterator it = v.begin(); it != v.end(); ++it) cout << *it;
+    cout << endl;
+}
+
+int main()
+{
+    ltx::vector<bool> v;
+    for(int i=0; i<10; ++i) v.push_back(i % 3 == 0);
+    print(v);                                   // 1001001001
+    v[1] = true;
+    v[0].flip();
+    print(v);                                   // 0101001001
+    v.insert(v.begin() + 2, 3, true);
+    print(v);                                   // 0111101001001
+    v.erase(v.begin(), v.begin() + 4);
+    print(v);                                   // 101001001
+    cout << "size " << v.size() << " count " << v.count()
+         << " find_first " << v.find_first() << " find_next " << v.find_next(0) << endl;
+
+    // 跨字的插入, 删除和查找
+    ltx::vector<bool> w(200, false);
+    w[150] = true;
+    w.insert(w.begin() + 10, true);
+    assert(w.find_first() == 10 && w.find_next(10) == 151 && w.find_next(151) == w.size());
+    w.erase(w.begin() + 10);
+    assert(w.find_first() == 150 && w.count() == 1);
+    w.flip();
+    assert(w.count() == 199 && w.find_first() == 0);
+    w.resize(70);
+    w.resize(130, false);
+    assert(w.count() == 70);
+
+    // 按位与和或
+    ltx::vector<bool> a(130, false), b(130, false);
+    for(size_t i=0; i<130; i+=2) a[i] = true;
+    for(size_t i=0; i<130; i+=3) b[i] = true;
+    ltx::vector<bool> c(a);
+    c &= b;
+    assert(c.count() == 22);                    // 6的倍数
+    c = a;
+    c |= b;
+    assert(c.count() == 65 + 44 - 22);
+    ltx::vector<bool> d(64, true);
+    c = a;
+    c &= d;                                     // d较短, 64之后的位视为0
+    assert(c.count() == 32);
+    c = ltx::vector<bool>(130, false);
+    c |= d;
+    assert(c.count() == 64);
+    cout << "bitwise ok" << endl;
+
+    // 空间和统计
+    const size_t N = 100000000;
+    ltx::vector<bool> bits(N, false);
+    ltx::vector<char> bytes(N, 0);
+    for(size_t i=0; i<N; i+=7) bits[i] = true, bytes[i] = 1;
+    cout << "vector<bool> capacity " << bits.capacity()/8/(1024*1024) << " MB, "
+         << "vector<char> " << bytes.capacity()/(1024*1024) << " MB" << endl;
+
+    auto t0 = chrono::steady_clock::now();
+    size_t n1 = bits.count();
+    auto t1 = chrono::steady_clock::now();
+    size_t n2 = 0;
+    for(size_t i=0; i<N; ++i) n2 += bytes[i] != 0;
+    auto t2 = chrono::steady_clock::now();
+    cout << "count " << n1 << ": " << chrono::duration<double, milli>(t1-t0).count() << " ms, "
+         << "vector<char> " << n2 << ": " << chrono::duration<double, milli>(t2-t1).count() << " ms" << endl;
+    return 0;
+}
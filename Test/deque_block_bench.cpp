@@ -0,0 +1,62 @@
+// deque缓冲区大小对push_back和顺序遍历的影响
+// 原来的512字节/至少1个元素, 默认值(512字节/至少8个), 4KB, 64KB
+#include "../deque.h"
+#include <iostream>
+#include <chrono>
+using namespace std;
+
+template <size_t S>
+struct rec
+{
+    long key;
+    char pad[S - sizeof(long)];
+};
+
+template <typename T, size_t BufSiz>
+void run(const char * name, size_t n)
+{
+    typedef ltx::deque<T, ltx::alloc, BufSiz> deque_type;
+    auto t0 = chrono::steady_clock::now();
+    deque_type d;
+    T x = T();
+    for(size_t i=0; i<n; ++i)
+    {
+        x.key = (long)i;
+        d.push_back(x);
+    }
+    auto t1 = chrono::steady_clock::now();
+    long sum = 0;
+    for(int r=0; r<4; ++r)
+        for(typename deque_type::iterator it = d.begin(); it != d.end(); ++it) sum += (*it).key;
+    auto t2 = chrono::steady_clock::now();
+    cout << "  " << name << " (" << ltx::__dequeue_buf_size(BufSiz, sizeof(T)) << "/block): push "
+         << chrono::duration<double, milli>(t1-t0).count() << " ms, scan x4 "
+         << chrono::duration<double, milli>(t2-t1).count() << " ms" << (sum == 0 ? "!" : "") << endl;
+}
+
+template <size_t S>
+void bench()
+{
+    typedef rec<S> T;
+    const size_t n = 32*1024*1024 / S;
+    for(int round=0; round<2; ++round)
+    {
+        // 第一轮只用来预热内存
+        if(round == 1) cout << "sizeof(T) = " << S << ", " << n << " elements" << endl;
+        else cout.setstate(ios::failbit);
+        run<T, ltx::deque_buf_elems<T, 512, 1>::value>("512B", n);
+        run<T, 0>("default", n);
+        run<T, ltx::deque_buf_elems<T, 4096, 8>::value>("4KB", n);
+        run<T, ltx::deque_buf_elems<T, 65536, 8>::value>("64KB", n);
+        cout.clear();
+    }
+}
+
+int main()
+{
+    bench<16>();
+    bench<256>();
+    bench<1024>();
+    bench<4096>();
+    return 0;
+}
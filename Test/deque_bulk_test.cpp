@@ -0,0 +1,210 @@
+// deque的区间构造, 区间插入, assign, append, 移动和emplace
+// 比较逐个push_back和一次append填充deque的耗时
+#include "../deque.h"
+#include "../list.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iterator>
+#include <stdexcept>
+#include <chrono>
+#include <cassert>
+#include <type_traits>
+using namespace std;
+
+// 移动只交换map, 不配置内存
+static_assert(std::is_nothrow_move_constructible<ltx::deque<int> >::value, "deque move ctor");
+static_assert(std::is_nothrow_move_assignable<ltx::deque<int> >::value, "deque move assign");
+
+template <typename Deque>
+void print(const Deque& d)
+{
+    for(typename Deque::const_iterator it = d.begin(); it != d.end(); ++it) cout << *it << ' ';
+    cout << endl;
+}
+
+template <typename Deque, typename Vector>
+bool same(const Deque& d, const Vector& v)
+{
+    if(d.size() != v.size()) return false;
+    typename Deque::const_iterator it = d.begin();
+    for(size_t i=0; i<v.size(); ++i, ++it)
+        if(!(*it == v[i])) return false;
+    return true;
+}
+
+// 复制构造到第fail_at次时抛出异常, live记录存活的对象数
+struct thrower
+{
+    static int live;
+    static int fail_at;
+    int v;
+    thrower(int x) : v(x) { ++live; }
+    thrower(const thrower& x) : v(x.v)
+    {
+        if(fail_at > 0 && --fail_at == 0) throw std::runtime_error("copy");
+        ++live;
+    }
+    thrower& operator=(const thrower& x) { v = x.v; return *this; }
+    ~thrower() { --live; }
+};
+int thrower::live = 0;
+int thrower::fail_at = 0;
+
+// 区间操作中途失败时不能泄漏已构造的元素, 原有的元素保持不变
+template <typename Iterator>
+void check_rollback(Iterator first, Iterator last)
+{
+    ltx::deque<thrower> d;
+    for(int i=0; i<100; ++i) d.push_back(thrower(i));
+    const int before = thrower::live;
+    for(int where=0; where<3; ++where)
+    {
+        thrower::fail_at = 150;
+        bool thrown = false;
+        try
+        {
+            if(where == 0) d.insert(d.begin(), first, last);
+            else if(where == 1) d.insert(d.end(), first, last);
+            else ltx::deque<thrower> c(first, last);
+        }
+        catch(const std::runtime_error&) { thrown = true; }
+        thrower::fail_at = 0;
+        assert(thrown && thrower::live == before && d.size() == 100);
+        assert(d.front().v == 0 && d.back().v == 99);
+    }
+}
+
+int main()
+{
+    int a[] = {1, 2, 3, 4, 5};
+    ltx::deque<int> d(a, a + 5);
+    print(d);                                   // 1 2 3 4 5
+    ltx::deque<int> n(4, 9);                    // 两个整数: 4个9
+    print(n);
+    d.insert(d.begin() + 2, a, a + 3);
+    print(d);                                   // 1 2 1 2 3 3 4 5
+    d.assign(3, 7);
+    print(d);                                   // 7 7 7
+    d.assign(a + 1, a + 4);
+    print(d);                                   // 2 3 4
+    d.append(n.begin(), n.end());
+    print(d);                                   // 2 3 4 9 9 9 9
+
+    // 各种插入位置和长度, 和vector对照
+    std::vector<int> ref;
+    ltx::deque<int> t;
+    for(int i=0; i<300; ++i) ref.push_back(i), t.push_back(i);
+    std::vector<int> src;
+    for(int i=0; i<700; ++i) src.push_back(-i);
+    size_t positions[] = {0, 1, 50, 150, 250, 299, 300};
+    size_t lengths[] = {0, 1, 10, 100, 200, 700};
+    for(size_t pos : positions)
+        for(size_t len : lengths)
+        {
+            std::vector<int> r(ref);
+            r.insert(r.begin() + pos, src.begin(), src.begin() + len);
+            ltx::deque<int> x(t);
+            x.insert(x.begin() + pos, src.data(), src.data() + len);
+            assert(same(x, r));
+            ltx::deque<int> y(t);
+            y.insert(y.begin() + pos, src.begin(), src.begin() + len);
+            assert(same(y, r));
+        }
+
+    // 前向迭代器(list)和输入迭代器(istream_iterator)
+    ltx::list<string> l;
+    l.push_back("a");
+    l.push_back("b");
+    l.push_back("c");
+    ltx::deque<string> s(l.begin(), l.end());
+    s.insert(s.begin() + 1, l.begin(), l.end());
+    print(s);                                   // a a b c b c
+    istringstream in("10 20 30");
+    ltx::deque<int> from_stream((istream_iterator<int>(in)), istream_iterator<int>());
+    print(from_stream);                         // 10 20 30
+
+    // 移动和emplace
+    ltx::deque<string> m;
+    string big(100, 'x');
+    m.push_back(std::move(big));
+    assert(big.empty() && m.back().size() == 100);
+    m.emplace_back(3, 'y');
+    m.emplace_front(2, 'z');
+    m.emplace(m.begin() + 1, "mid");
+    m.insert(m.begin() + 2, string("moved"));
+    print(m);                                   // zz mid moved xxx... yyy
+    ltx::deque<std::vector<int> > dv;
+    dv.emplace_back(size_t(3), 7);
+    dv.emplace(dv.begin(), size_t(2), 1);
+    assert(dv.size() == 2 && dv[0].size() == 2 && dv[1].size() == 3);
+
+    // 被移走的deque没有map, 各种操作都要可用
+    {
+        ltx::deque<int> src;
+        for(int i=0; i<1000; ++i) src.push_back(i);
+        ltx::deque<int> dst(std::move(src));
+        assert(src.size() == 0 && src.empty() && src.begin() == src.end() && dst.size() == 1000);
+        src.clear();
+        src.push_back(1);
+        src.push_front(0);
+        assert(src.size() == 2 && src[0] == 0 && src[1] == 1);
+        dst = std::move(src);
+        assert(dst.size() == 2 && src.size() == 0);
+        src.emplace_front(5);
+        assert(src.size() == 1 && src.front() == 5);
+        dst = std::move(src);
+        src.insert(src.begin(), size_t(3), 4);
+        assert(src.size() == 3 && src.back() == 4);
+        ltx::deque<int> e(std::move(src));
+        src.insert(src.end(), a, a + 5);
+        assert(same(src, std::vector<int>(a, a + 5)));
+        e = std::move(src);
+        src.resize(10, 2);
+        assert(src.size() == 10);
+        e = std::move(src);
+        src.assign(a, a + 2);
+        assert(src.size() == 2);
+        e = std::move(src);
+        src = dst;
+        assert(same(src, std::vector<int>(1, 5)));
+        e = std::move(src);
+        src.swap(e);
+        assert(src.size() == 1 && e.size() == 0);
+        e.push_back(8);
+        assert(e.end() - e.begin() == 1);
+    }
+
+    // 元素复制时抛出异常, 源区间来自vector和list
+    {
+        std::vector<thrower> tv;
+        ltx::list<thrower> tl;
+        for(int i=0; i<300; ++i) tv.push_back(thrower(i)), tl.push_back(thrower(i));
+        const int live = thrower::live;
+        check_rollback(tv.begin(), tv.end());
+        check_rollback(tl.begin(), tl.end());
+        assert(thrower::live == live);
+    }
+
+    // 填充耗时
+    const int N = 1 << 22;
+    std::vector<int> data(N, 1);
+    for(int round=0; round<2; ++round)
+    {
+        auto t0 = chrono::steady_clock::now();
+        ltx::deque<int> p;
+        for(int i=0; i<N; ++i) p.push_back(data[i]);
+        auto t1 = chrono::steady_clock::now();
+        ltx::deque<int> q;
+        q.append(data.data(), data.data() + N);
+        auto t2 = chrono::steady_clock::now();
+        ltx::deque<int> c(data.data(), data.data() + N);
+        auto t3 = chrono::steady_clock::now();
+        if(round == 0) continue;
+        cout << N << " ints: push_back " << chrono::duration<double, milli>(t1-t0).count()
+             << " ms, append " << chrono::duration<double, milli>(t2-t1).count()
+             << " ms, range constructor " << chrono::duration<double, milli>(t3-t2).count() << " ms" << endl;
+    }
+    return 0;
+}
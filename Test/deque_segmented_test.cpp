@@ -0,0 +1,91 @@
+// deque的分段算法: copy, fill, find, for_each, accumulate, uninitialized_copy按缓冲区处理
+// 和逐个元素的std::copy, 以及对连续数组的memcpy比较复制的耗时
+#include "../deque.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cassert>
+#include <cstring>
+using namespace std;
+
+struct adder
+{
+    long sum;
+    adder() : sum(0) {}
+    void operator()(int x) { sum += x; }
+};
+
+int main()
+{
+    // 起点不在缓冲区开头, 跨越多个缓冲区
+    ltx::deque<int> d;
+    for(int i=0; i<1000; ++i) d.push_back(i);
+    for(int i=1; i<=37; ++i) d.push_front(-i);
+
+    std::vector<int> out(d.size());
+    int * e = ltx::copy(d.begin(), d.end(), out.data());
+    assert(e == out.data() + out.size() && out[0] == -37 && out[37] == 0 && out[1036] == 999);
+
+    // 从数组复制到deque, 刚好到缓冲区尾部时返回下一个缓冲区的开头
+    std::vector<int> in(500);
+    for(int i=0; i<500; ++i) in[i] = 10000 + i;
+    ltx::deque<int>::iterator r = ltx::copy(in.data(), in.data() + 500, d.begin() + 100);
+    assert(r == d.begin() + 600 && d[99] == 62 && d[100] == 10000 && d[599] == 10499 && d[600] == 563);
+    for(int k=0; k<300; ++k)
+    {
+        ltx::deque<int>::iterator it = ltx::copy(in.data(), in.data() + k, d.begin() + 3);
+        assert(it - d.begin() == 3 + k);
+    }
+
+    // deque之间复制, 两边的缓冲区边界不对齐
+    ltx::deque<int> d2(d);
+    for(size_t i=0; i<d.size(); ++i) assert(d2[i] == d[i]);
+    ltx::deque<int> d3;
+    for(int i=0; i<1037; ++i) d3.push_back(0);
+    ltx::copy(d.begin() + 5, d.end(), d3.begin() + 1);
+    assert(d3[0] == 0 && d3[1] == d[5] && d3[1032] == d[1036]);
+
+    ltx::fill(d3.begin() + 10, d3.end() - 10, 7);
+    assert(d3[9] != 7 && d3[10] == 7 && d3[1026] == 7 && d3[1027] != 7);
+    assert(ltx::find(d.begin(), d.end(), 998) - d.begin() == 1035);
+    assert(ltx::find(d.begin(), d.end(), 123456) == d.end());
+    const ltx::deque<int>& cd = d;
+    assert(ltx::find(cd.begin(), cd.end(), -37) == cd.begin());
+
+    long expect = 0;
+    for(size_t i=0; i<d.size(); ++i) expect += d[i];
+    assert(ltx::for_each(d.begin(), d.end(), adder()).sum == expect);
+    assert(ltx::accumulate(d.begin(), d.end(), 0L) == expect);
+    assert(ltx::accumulate(d.begin() + 1, d.begin() + 1, 5L) == 5);
+
+    // 非平凡的元素
+    ltx::deque<string> s;
+    for(int i=0; i<300; ++i) s.push_back(string(20, char('a' + i % 26)));
+    ltx::deque<string> s2(s);
+    assert(s2.size() == 300 && s2[299] == s[299]);
+    s2.erase(s2.begin() + 3, s2.begin() + 200);
+    assert(s2.size() == 103 && s2[3] == s[200] && s2[102] == s[299]);
+    cout << "ok" << endl;
+
+    // 复制耗时, 数据放得进缓存, 反复复制
+    const size_t N = 1 << 16;
+    const int M = 2000;
+    ltx::deque<int> big;
+    for(size_t i=0; i<N; ++i) big.push_back((int)i);
+    std::vector<int> buf(N), src(N, 1);
+    auto t0 = chrono::steady_clock::now();
+    for(int i=0; i<M; ++i) std::copy(big.begin(), big.end(), buf.begin());
+    auto t1 = chrono::steady_clock::now();
+    for(int i=0; i<M; ++i) ltx::copy(big.begin(), big.end(), buf.data());
+    auto t2 = chrono::steady_clock::now();
+    for(int i=0; i<M; ++i) ltx::copy(src.data(), src.data() + N, big.begin());
+    auto t3 = chrono::steady_clock::now();
+    for(int i=0; i<M; ++i) memcpy(buf.data() + (i & 1), src.data(), (N - 1) * sizeof(int));
+    auto t4 = chrono::steady_clock::now();
+    cout << "copy out of deque: element by element " << chrono::duration<double, milli>(t1-t0).count()
+         << " ms, segmented " << chrono::duration<double, milli>(t2-t1).count() << " ms" << endl;
+    cout << "copy into deque: segmented " << chrono::duration<double, milli>(t3-t2).count()
+         << " ms, memcpy " << chrono::duration<double, milli>(t4-t3).count() << " ms" << endl;
+    return 0;
+}
@@ -0,0 +1,58 @@
+// deque的备用缓冲区: 队列式使用(push_back/pop_front)时稳定状态下不再配置缓冲区
+#include "../queue.h"
+#include "../deque.h"
+#include <iostream>
+#include <chrono>
+#include <cassert>
+using namespace std;
+
+// 统计配置次数
+struct counting_alloc
+{
+    static size_t allocs;
+    static void * allocate(size_t n) { ++allocs; return ltx::alloc::allocate(n); }
+    static void deallocate(void * p, size_t n) { ltx::alloc::deallocate(p, n); }
+};
+size_t counting_alloc::allocs = 0;
+
+int main()
+{
+    ltx::queue<int, ltx::deque<int, counting_alloc> > q;
+    for(int i=0; i<1000; ++i) q.push(i);
+
+    // 队列长度保持在1000左右, 反复进出
+    const long N = 10000000;
+    size_t before = counting_alloc::allocs;
+    auto begin = chrono::steady_clock::now();
+    long sum = 0;
+    for(long i=0; i<N; ++i)
+    {
+        q.push((int)i);
+        sum += q.front();
+        q.pop();
+    }
+    auto end = chrono::steady_clock::now();
+    cout << N << " push/pop: " << counting_alloc::allocs - before << " allocations, "
+         << chrono::duration<double, milli>(end-begin).count() << " ms" << endl;
+    assert(q.size() == 1000 && q.front() == N - 1000);
+
+    // 两端交替增长和收缩
+    ltx::deque<int, counting_alloc> d;
+    for(int round=0; round<3; ++round)
+    {
+        for(int i=0; i<5000; ++i) d.push_front(i), d.push_back(i);
+        while(!d.empty()) d.pop_back();
+    }
+    d.shrink_to_fit();
+    cout << "spare blocks released by shrink_to_fit" << endl;
+
+    // 清空和区间删除后备用的缓冲区被再次使用
+    for(int i=0; i<100000; ++i) d.push_back(i);
+    d.erase(d.begin() + 10, d.end() - 10);
+    assert(d.size() == 20 && d[9] == 9 && d[10] == 99990);
+    d.clear();
+    for(int i=0; i<1000; ++i) d.push_back(i);
+    assert(d.back() == 999);
+    cout << "ok " << sum << endl;
+    return 0;
+}
@@ -1,8 +1,15 @@
 #include "../list.h"
 #include <random>
 #include <iostream>
+#include <cassert>
+#include <type_traits>
+#include <utility>
 using namespace std;
 
+// 哨兵节点在对象内部, 移动不配置内存
+static_assert(std::is_nothrow_move_constructible<ltx::list<int> >::value, "list move ctor");
+static_assert(std::is_nothrow_move_assignable<ltx::list<int> >::value, "list move assign");
+
 
 int main()
 {
@@ -58,6 +65,21 @@ int main()
     }
     cout << endl;
 
+    // 移动和交换后两边的哨兵都要指回自己
+    size_t n = l.size();
+    ltx::list<int> m(std::move(l));
+    assert(l.empty() && m.size() == n);
+    l.push_back(7);
+    m = std::move(l);
+    assert(l.empty() && m.size() == 1 && m.front() == 7);
+    l.push_back(1); l.push_back(2);
+    l.swap(m);
+    assert(l.size() == 1 && l.front() == 7 && m.size() == 2 && m.back() == 2);
+    ltx::list<int> e;
+    e.swap(m);
+    assert(m.empty() && e.size() == 2 && e.front() == 1);
+    m.push_back(3);
+    assert(m.size() == 1);
 
     return 0;
 }
\ No newline at end of file
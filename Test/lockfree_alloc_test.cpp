@@ -0,0 +1,74 @@
+#include "../stl_lockfree_alloc.h"
+#include "../list.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+using namespace std;
+
+// 单生产者单消费者的环形队列, 用来在线程之间传递区块
+template <typename T, size_t N>
+struct spsc_queue
+{
+    T buf[N];
+    atomic<size_t> head{0}, tail{0};
+    bool push(T x)
+    {
+        size_t t = tail.load(memory_order_relaxed);
+        if(t - head.load(memory_order_acquire) == N) return false;
+        buf[t%N] = x;
+        tail.store(t+1, memory_order_release);
+        return true;
+    }
+    bool pop(T& x)
+    {
+        size_t h = head.load(memory_order_relaxed);
+        if(h == tail.load(memory_order_acquire)) return false;
+        x = buf[h%N];
+        head.store(h+1, memory_order_release);
+        return true;
+    }
+};
+
+const int N = 200000;
+spsc_queue<long*, 1024> q[4];
+atomic<int> errors(0);
+
+// 流水线: 生产者配置并写入区块, 消费者检查后释放
+void producer(int id)
+{
+    for(long i=0; i<N; ++i)
+    {
+        long * p = (long*) ltx::lockfree_alloc::allocate(sizeof(long)*3);
+        p[0] = id; p[1] = i; p[2] = id ^ i;
+        while(!q[id].push(p)) this_thread::yield();
+    }
+}
+void consumer(int id)
+{
+    for(long i=0; i<N; ++i)
+    {
+        long * p;
+        while(!q[id].pop(p)) this_thread::yield();
+        if(p[0] != id || p[1] != i || p[2] != (id ^ i)) ++errors;
+        ltx::lockfree_alloc::deallocate(p, sizeof(long)*3);
+    }
+}
+
+int main()
+{
+    vector<thread> ts;
+    for(int i=0; i<4; ++i)
+    {
+        ts.push_back(thread(producer, i));
+        ts.push_back(thread(consumer, i));
+    }
+    for(auto & t : ts) t.join();
+    cout << "pipeline errors: " << errors << endl;
+
+    ltx::list<int, ltx::lockfree_alloc> l;
+    for(int i=0; i<10; ++i) l.push_back(i);
+    for(auto ite = l.begin(); ite!=l.end(); ++ite) cout << *ite << " ";
+    cout << endl;
+    return 0;
+}
@@ -0,0 +1,92 @@
+// mapped_vector: 数组存放在映射的文件中, 重新打开时不需要重建
+// 比较重建100万个元素的有序数组和直接映射已有文件的耗时
+#include "../mapped_vector.h"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+using namespace std;
+
+struct entry
+{
+    long key;
+    long value;
+    bool operator<(const entry& x) const { return key < x.key; }
+};
+
+int main()
+{
+    const char * path = "/tmp/mapped_vector_test.bin";
+    const long N = 1000000;
+    std::remove(path);
+
+    auto t0 = chrono::steady_clock::now();
+    {
+        ltx::mapped_vector<entry> v(path);
+        // 乱序生成再排序, 相当于每次启动时重建查找表
+        for(long i=0; i<N; ++i)
+        {
+            entry e = {(i * 7919) % N, i};
+            v.push_back(e);
+        }
+        std::sort(v.begin(), v.end());
+        v.shrink_to_fit();
+        cout << "built " << v.size() << " capacity " << v.capacity() << endl;
+        bool flushed = v.flush();
+        assert(flushed);
+    }
+    auto t1 = chrono::steady_clock::now();
+
+    // 只读打开, 不读取任何数据
+    ltx::mapped_vector<entry> r(path, true);
+    auto t2 = chrono::steady_clock::now();
+    entry k = {123456, 0};
+    const entry * it = std::lower_bound(r.begin(), r.end(), k);
+    cout << "size " << r.size() << " lookup " << it->key << " -> " << it->value << endl;
+    // 只读映射不能修改
+    bool thrown = false;
+    try { r.push_back(k); } catch(const std::runtime_error&) { thrown = true; }
+    assert(thrown);
+    thrown = false;
+    try { r.clear(); } catch(const std::runtime_error&) { thrown = true; }
+    assert(thrown && r.size() == (size_t)N);
+    cout << "rebuild " << chrono::duration<double, milli>(t1-t0).count() << " ms, "
+         << "reopen " << chrono::duration<double, milli>(t2-t1).count() << " ms" << endl;
+
+    // 重新以读写方式打开, 继续追加
+    {
+        ltx::mapped_vector<entry> w(path);
+        entry e = {N, N};
+        w.push_back(w[0]);
+        w.push_back(e);
+        w.resize(N + 10);
+        assert(w.size() == (size_t)N + 10 && w[N].key == 0 && w[N+1].key == N && w[N+9].key == 0);
+        w.resize(N);
+    }
+
+    // 元素大小不同的文件不能打开
+    ltx::mapped_vector<int> bad;
+    cout << "open as int: " << bad.open(path) << endl;
+    cout << "open missing read-only: " << bad.open("/tmp/no_such_mapped_vector.bin", true) << endl;
+
+    // 没有打开文件时修改操作抛出异常, clear和shrink_to_fit什么也不做
+    int fails = 0;
+    try { bad.pop_back(); } catch(const std::runtime_error&) { ++fails; }
+    try { bad.resize(0); } catch(const std::runtime_error&) { ++fails; }
+    try { bad.resize(5); } catch(const std::runtime_error&) { ++fails; }
+    try { bad.push_back(1); } catch(const std::runtime_error&) { ++fails; }
+    try { bad.reserve(10); } catch(const std::runtime_error&) { ++fails; }
+    bad.clear();
+    bad.shrink_to_fit();
+    assert(fails == 5 && bad.size() == 0);
+
+    ltx::mapped_vector<entry> again;
+    bool opened = again.open(path, true);
+    assert(opened && again.size() == (size_t)N && again[N-1].key == N-1);
+    ltx::mapped_vector<entry> moved(std::move(again));
+    assert(!again.is_open() && moved.size() == (size_t)N);
+    cout << "ok" << endl;
+    std::remove(path);
+    return 0;
+}
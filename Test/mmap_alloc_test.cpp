@@ -0,0 +1,31 @@
+#include "../stl_mmap_alloc.h"
+#include "../vector.h"
+#include <iostream>
+using namespace std;
+
+int main()
+{
+    // 小于阈值的请求和default_alloc一样
+    ltx::vector<int, ltx::mmap_alloc<> > small;
+    for(int i=0; i<100; ++i) small.push_back(i);
+    cout << small[99] << endl;
+
+    // 大vector的缓冲区来自mmap
+    ltx::vector<long, ltx::mmap_alloc<> > big;
+    for(long i=0; i<(1<<22); ++i) big.push_back(i);
+    cout << big.size() << " " << big[(1<<22)-1] << endl;
+    cout << "2MB aligned: " << (((size_t)&big[0] & (2*1024*1024-1)) == 0) << endl;
+
+    // mremap扩展, 内容保持不变
+    typedef ltx::mmap_alloc<1024*1024> alloc;
+    char * p = (char*) alloc::allocate(3*1024*1024);
+    memset(p, 'x', 3*1024*1024);
+    p = (char*) alloc::reallocate(p, 3*1024*1024, 64*1024*1024);
+    p[64*1024*1024-1] = 'y';
+    cout << p[0] << p[3*1024*1024-1] << p[64*1024*1024-1] << endl;
+    alloc::deallocate(p, 64*1024*1024);
+
+    ltx::vector<int, ltx::mmap_alloc<> > filled(1000000, 7);
+    cout << filled[999999] << endl;
+    return 0;
+}
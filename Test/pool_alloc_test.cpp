@@ -0,0 +1,76 @@
+#include "../stl_pool_alloc.h"
+#include "../vector.h"
+#include "../list.h"
+#include "../deque.h"
+#include "../map.h"
+#include <iostream>
+#include <utility>
+using namespace std;
+
+typedef ltx::vector<int, ltx::pool_alloc> pvector;
+typedef ltx::list<int, ltx::pool_alloc> plist;
+typedef ltx::deque<int, ltx::pool_alloc> pdeque;
+typedef ltx::map<int, int, less<int>, ltx::pool_alloc> pmap;
+
+int main()
+{
+    // 无状态配置器不增加容器大小
+    cout << "sizeof vector: " << sizeof(ltx::vector<int>) << " " << sizeof(pvector) << endl;
+    cout << "sizeof list: " << sizeof(ltx::list<int>) << " " << sizeof(plist) << endl;
+
+    ltx::memory_pool tenant1, tenant2;
+    {
+        pvector v(tenant1);
+        plist l(tenant1);
+        pdeque d(tenant1);
+        pmap m(less<int>(), tenant2);
+        for(int i=0; i<100; ++i)
+        {
+            v.push_back(i);
+            l.push_back(i);
+            d.push_back(i);
+            m[i] = i*i;
+        }
+        cout << "tenant1: " << tenant1.bytes_reserved() << " tenant2: " << tenant2.bytes_reserved() << endl;
+
+        // 复制时配置器一起复制
+        pvector v2 = v;
+        plist l2 = l;
+        pdeque d2 = d;
+        pmap m2 = m;
+        cout << (v2.get_allocator() == v.get_allocator()) << " "
+             << (l2.get_allocator() == l.get_allocator()) << " "
+             << (d2.get_allocator() == d.get_allocator()) << " "
+             << (m2.get_allocator() == m.get_allocator()) << endl;
+        cout << v2[99] << " " << l2.back() << " " << d2[99] << " " << m2[99] << endl;
+
+        // 交换时配置器一起交换
+        pvector v3(tenant2);
+        v3.push_back(-1);
+        v3.swap(v2);
+        cout << (&v3.get_allocator().resource() == &tenant1) << " " << v3[99] << " " << v2[0] << endl;
+
+        // 移动
+        plist l3 = std::move(l2);
+        cout << l3.back() << " " << l2.empty() << endl;
+        pdeque d3(tenant2);
+        d3 = d;
+        cout << (&d3.get_allocator().resource() == &tenant1) << " " << d3[50] << endl;
+        pmap m3(less<int>(), tenant1);
+        m3 = std::move(m2);
+        cout << (&m3.get_allocator().resource() == &tenant2) << " " << m3[10] << endl;
+        l.sort();
+        cout << l.front() << " " << (&l.get_allocator().resource() == &tenant1) << endl;
+    }
+
+    // 超过__MAX_BYTES的区块也由内存池记录, release时归还
+    ltx::memory_pool big;
+    void * p1 = big.allocate(10000);
+    void * p2 = big.allocate(20000);
+    big.allocate(64);
+    big.deallocate(p1, 10000);
+    cout << "large: " << (big.bytes_reserved() >= 20000) << " " << (p2 != nullptr) << endl;
+    big.release();
+    cout << "after release: " << big.bytes_reserved() << endl;
+    return 0;
+}
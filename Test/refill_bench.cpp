@@ -0,0 +1,47 @@
+// refill批量自适应的效果
+// 分别以默认方式和 -DLTX_ALLOC_FIXED_REFILL 编译运行, 比较refill次数和平均配置耗时
+#define LTX_ALLOC_STATS
+#include "../stl_alloc.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+using namespace std;
+
+int main()
+{
+    const int N = 2000000;
+    // 热门大小: list和rb_tree节点; 冷门大小: 偶尔配置一次
+    const size_t hot[] = {24, 40};
+    const size_t cold[] = {72, 120};
+    vector<void*> blocks;
+    blocks.reserve(N);
+
+    auto begin = chrono::steady_clock::now();
+    for(int i=0; i<N; ++i)
+    {
+        size_t n = (i%1000 == 0) ? cold[i/1000%2] : hot[i%2];
+        blocks.push_back(ltx::default_alloc::allocate(n));
+    }
+    auto end = chrono::steady_clock::now();
+    double ns = chrono::duration<double, nano>(end-begin).count() / N;
+
+    ltx::alloc_stats s = ltx::default_alloc::stats();
+    size_t refills = 0;
+    for(int i=0; i<ltx::__NFREELISTS; ++i) refills += s.classes[i].refills;
+
+#ifdef LTX_ALLOC_FIXED_REFILL
+    cout << "fixed batch" << endl;
+#else
+    cout << "adaptive batch" << endl;
+#endif
+    cout << "refills: " << refills << endl;
+    cout << "chunk_alloc calls: " << s.chunk_allocs << endl;
+    cout << "avg allocate: " << ns << " ns" << endl;
+    for(int i=0; i<ltx::__NFREELISTS; ++i)
+    {
+        if(s.classes[i].refills != 0)
+            cout << "  " << s.classes[i].block_size << " bytes: refills " << s.classes[i].refills
+                 << ", free " << s.classes[i].free_blocks << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+// 可平凡搬迁元素的重新配置和中间插入
+// record是平凡可复制的, 重新配置和后移元素用memcpy/memmove;
+// record_ctor的内容相同但有自定义的复制构造函数, 只能逐个复制
+// handle声明为可平凡搬迁, handle_slow相同但没有声明, 只能逐个移动构造再析构
+#include "../vector.h"
+#include "../deque.h"
+#include <iostream>
+#include <chrono>
+using namespace std;
+
+struct record
+{
+    long fields[8];
+};
+
+struct record_ctor
+{
+    long fields[8];
+    record_ctor() {}
+    record_ctor(const record_ctor & x) { for(int i=0; i<8; ++i) fields[i] = x.fields[i]; }
+    record_ctor & operator=(const record_ctor & x) 
+    { 
+        for(int i=0; i<8; ++i) fields[i] = x.fields[i]; 
+        return *this; 
+    }
+};
+
+// 独占句柄: 不可平凡复制, 但可以声明为可平凡搬迁
+struct handle
+{
+    int * p;
+    explicit handle(int v) : p(new int(v)) {}
+    handle(handle && x) noexcept : p(x.p) { x.p = nullptr; }
+    handle & operator=(handle && x) noexcept { std::swap(p, x.p); return *this; }
+    handle(const handle &) = delete;
+    ~handle() { delete p; }
+};
+struct handle_slow : handle
+{
+    explicit handle_slow(int v) : handle(v) {}
+};
+namespace ltx
+{
+    template <> struct is_trivially_relocatable<handle> : std::true_type {};
+}
+
+template <typename T>
+double bench_handle(const char * name)
+{
+    const int N = 1000000;
+    const int M = 200;
+    auto begin = chrono::steady_clock::now();
+    ltx::vector<T> v;
+    for(int i=0; i<N; ++i) v.emplace_back(i);
+    for(int i=0; i<M; ++i) v.emplace(v.begin() + v.size()/2, i);
+    auto end = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(end-begin).count();
+    cout << name << ": " << ms << " ms, relocatable " << ltx::is_trivially_relocatable<T>::value << endl;
+    return ms;
+}
+
+template <typename T>
+double bench(const char * name)
+{
+    const int N = 200000;
+    const int M = 500;
+    auto begin = chrono::steady_clock::now();
+    ltx::vector<T> v;
+    T r;
+    for(int i=0; i<N; ++i)
+    {
+        r.fields[0] = i;
+        v.push_back(r);
+    }
+    // 在中间插入, 每次后移一半的元素
+    for(int i=0; i<M; ++i) v.insert(v.begin() + v.size()/2, r);
+    auto end = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(end-begin).count();
+    cout << name << ": " << ms << " ms, relocatable " << ltx::is_trivially_relocatable<T>::value << endl;
+    return ms;
+}
+
+int main()
+{
+    double slow = bench<record_ctor>("record_ctor");
+    double fast = bench<record>("record");
+    cout << "speedup: " << slow/fast << endl;
+    slow = bench_handle<handle_slow>("handle_slow");
+    fast = bench_handle<handle>("handle");
+    cout << "speedup: " << slow/fast << endl;
+
+    ltx::vector<handle> hs;
+    for(int i=0; i<100; ++i) hs.emplace_back(i);
+    hs.emplace(hs.begin(), -1);
+    int sum = 0;
+    for(size_t i=0; i<hs.size(); ++i) sum += *hs[i].p;
+    cout << "handles: " << hs.size() << " sum " << sum << endl;
+
+    ltx::vector<int> v(5, 1);
+    v.insert(v.begin()+2, 3, v[0]+1);
+    v.insert(v.begin()+1, 2, 7);
+    for(size_t i=0; i<v.size(); ++i) cout << v[i] << " ";
+    cout << endl;
+
+    // deque的map重新配置
+    ltx::deque<int> d;
+    for(int i=0; i<100000; ++i)
+    {
+        if(i%2) d.push_back(i);
+        else d.push_front(i);
+    }
+    cout << "deque: " << d.size() << " " << d.front() << " " << d.back() << endl;
+    return 0;
+}
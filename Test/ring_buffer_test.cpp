@@ -0,0 +1,111 @@
+// ring_buffer: 作为queue和stack的Sequence, 固定容量, 覆盖模式
+// 和deque比较有界队列的吞吐
+#include "../ring_buffer.h"
+#include "../queue.h"
+#include "../stack.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cassert>
+#include <type_traits>
+using namespace std;
+
+int main()
+{
+    ltx::queue<int, ltx::ring_buffer<int> > q;
+    for(int i=0; i<20; ++i) q.push(i);
+    for(int i=0; i<15; ++i) q.pop();
+    for(int i=20; i<30; ++i) q.push(i);        // 回绕后继续增长
+    cout << q.size() << " " << q.front() << " " << q.back() << endl;     // 15 15 29
+
+    ltx::stack<string, ltx::ring_buffer<string> > s;
+    s.push("a");
+    s.push(string("b"));
+    cout << s.top();
+    s.pop();
+    cout << s.top() << endl;                    // ba
+
+    // 固定容量, 满了抛出异常
+    ltx::ring_buffer<int, 4> fixed;
+    for(int i=0; i<4; ++i) fixed.push_back(i);
+    bool thrown = false;
+    try { fixed.push_back(4); } catch(const std::length_error&) { thrown = true; }
+    assert(thrown && fixed.full() && fixed.capacity() == 4);
+
+    // 覆盖模式: 保留最近的5个值, 容量不是2的幂
+    ltx::ring_buffer<int, 5, true> window;
+    for(int i=0; i<12; ++i) window.push_back(i);
+    for(ltx::ring_buffer<int, 5, true>::iterator it = window.begin(); it != window.end(); ++it)
+        cout << *it << ' ';
+    cout << endl;                               // 7 8 9 10 11
+    window.push_front(100);                     // 从前端插入时覆盖最新的元素
+    assert(window.front() == 100 && window.back() == 10 && window.size() == 5);
+
+    // 两端操作, 复制, 移动
+    ltx::ring_buffer<string> r;
+    for(int i=0; i<10; ++i)
+    {
+        r.push_back(string(1, char('a' + i)));
+        r.push_front(string(1, char('A' + i)));
+    }
+    r.emplace_back(3, 'z');
+    assert(r.size() == 21 && r.front() == "J" && r[10] == "a" && r.back() == "zzz");
+    ltx::ring_buffer<string> r2(r);
+    r.pop_front();
+    r.pop_back();
+    assert(r2.size() == 21 && r2.front() == "J" && r.size() == 19 && r.back() == "j");
+    ltx::ring_buffer<string> r3(std::move(r2));
+    assert(r3.size() == 21 && r2.empty());
+    r2 = r3;
+    r3 = std::move(r);
+    assert(r2.size() == 21 && r3.size() == 19);
+    assert(r3.end() - r3.begin() == 19 && r3.begin()[18] == "j");
+
+    // 移动不配置空间, 不抛出异常; 移动后的固定容量缓冲区在下次插入时重新配置
+    static_assert(std::is_nothrow_move_constructible<ltx::ring_buffer<string, 4> >::value, "move");
+    static_assert(std::is_nothrow_move_assignable<ltx::ring_buffer<string> >::value, "move assign");
+    ltx::ring_buffer<string, 4> f1;
+    assert(f1.empty() && f1.capacity() == 4 && f1.begin() == f1.end());
+    f1.push_front("x");
+    f1.push_back("y");
+    ltx::ring_buffer<string, 4> f2(std::move(f1));
+    assert(f1.empty() && f2.size() == 2 && f2.front() == "x");
+    for(int i=0; i<4; ++i) f1.push_back("z");
+    assert(f1.full() && f1.back() == "z");
+    f2 = std::move(f1);
+    assert(f2.full() && f1.empty());
+    f1.emplace_front(2, 'w');
+    assert(f1.size() == 1 && f1.front() == "ww");
+    cout << "ok" << endl;
+
+    // 有界工作队列: 队列长度在0到1000之间来回
+    const int N = 20000000;
+    for(int round=0; round<2; ++round)
+    {
+        long sum = 0;
+        auto t0 = chrono::steady_clock::now();
+        {
+            ltx::queue<int, ltx::ring_buffer<int, 1024> > bounded;
+            for(int i=0; i<N; )
+            {
+                for(int k=0; k<1000; ++k) bounded.push(i++);
+                while(!bounded.empty()) sum += bounded.front(), bounded.pop();
+            }
+        }
+        auto t1 = chrono::steady_clock::now();
+        {
+            ltx::queue<int> dq;
+            for(int i=0; i<N; )
+            {
+                for(int k=0; k<1000; ++k) dq.push(i++);
+                while(!dq.empty()) sum -= dq.front(), dq.pop();
+            }
+        }
+        auto t2 = chrono::steady_clock::now();
+        if(round == 0) continue;
+        cout << N << " push/pop: ring_buffer " << chrono::duration<double, milli>(t1-t0).count()
+             << " ms, deque " << chrono::duration<double, milli>(t2-t1).count() << " ms"
+             << (sum == 0 ? "" : " mismatch") << endl;
+    }
+    return 0;
+}
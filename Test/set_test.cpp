@@ -1,7 +1,14 @@
 #include "../set.h"
 #include <iostream>
+#include <cassert>
+#include <type_traits>
+#include <utility>
 using namespace std;
 
+// header在对象内部, 移动不配置内存
+static_assert(std::is_nothrow_move_constructible<ltx::set<int> >::value, "set move ctor");
+static_assert(std::is_nothrow_move_assignable<ltx::set<int> >::value, "set move assign");
+
 int main()
 {
     ltx::set<int> s;
@@ -26,5 +33,22 @@ int main()
     
     for(auto ite : s) cout << ite << " "; cout << endl;
 
+    // 移动和交换后根节点的parent要指回各自的header
+    size_t n = s.size();
+    ltx::set<int> m(std::move(s));
+    assert(s.size() == 0 && s.begin() == s.end() && m.size() == n);
+    s.insert(5);
+    m = std::move(s);
+    assert(s.size() == 0 && m.size() == 1 && *m.begin() == 5);
+    for(int i=0; i<50; ++i) s.insert(i);
+    s.swap(m);
+    assert(s.size() == 1 && m.size() == 50);
+    int expect = 0;
+    for(auto ite : m) assert(ite == expect++);
+    for(auto ite = m.end(); ite != m.begin(); ) assert(*--ite == --expect);
+    m.erase(m.begin());
+    m.insert(100);
+    assert(m.size() == 50 && *m.find(100) == 100);
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+// 大区块分级的效果
+// 分别以默认方式(128)和 -DLTX_ALLOC_MAX_BYTES=4096 编译运行, 比较150~400字节区块的配置/释放耗时
+#define LTX_ALLOC_STATS
+#include "../stl_alloc.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+using namespace std;
+
+int main()
+{
+    const int N = 200000;
+    const int ROUNDS = 20;
+    vector<void*> blocks(N);
+    vector<size_t> sizes(N);
+    unsigned seed = 1;
+    for(int i=0; i<N; ++i)
+    {
+        seed = seed*1103515245 + 12345;
+        sizes[i] = 150 + (seed>>16)%251;
+    }
+
+    auto begin = chrono::steady_clock::now();
+    for(int r=0; r<ROUNDS; ++r)
+    {
+        for(int i=0; i<N; ++i) blocks[i] = ltx::default_alloc::allocate(sizes[i]);
+        for(int i=0; i<N; ++i) ltx::default_alloc::deallocate(blocks[i], sizes[i]);
+    }
+    auto end = chrono::steady_clock::now();
+    double ns = chrono::duration<double, nano>(end-begin).count() / (N*ROUNDS);
+
+    // 内部碎片: 区块大小与请求大小之差
+    size_t requested = 0, rounded = 0;
+    for(int i=0; i<N; ++i)
+    {
+        requested += sizes[i];
+        if(sizes[i] <= (size_t)ltx::__MAX_BYTES) rounded += ltx::size_class::round_up(sizes[i]);
+        else rounded += sizes[i];
+    }
+
+    ltx::alloc_stats s = ltx::default_alloc::stats();
+    cout << "__MAX_BYTES: " << ltx::__MAX_BYTES << ", free-lists: " << ltx::__NFREELISTS << endl;
+    cout << "large allocations: " << s.large_allocations << endl;
+    cout << "avg allocate+deallocate: " << ns << " ns" << endl;
+    cout << "internal fragmentation: " << 100.0*(rounded-requested)/rounded << "%" << endl;
+    return 0;
+}
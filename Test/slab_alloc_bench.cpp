@@ -0,0 +1,67 @@
+// slab配置器与default_alloc的遍历性能比较
+// 两个节点大小相同的list交替构建, 再随机删除和插入一部分节点,
+// default_alloc下两个list的节点来自同一个free-list而交错存放, slab_alloc下按节点类型分开存放
+#include "../stl_slab_alloc.h"
+#include "../list.h"
+#include "../set.h"
+#include <iostream>
+#include <chrono>
+using namespace std;
+
+template <typename Alloc>
+double bench(const char * name)
+{
+    const int N = 1000000;
+    const int ROUNDS = 20;
+    ltx::list<long, Alloc> a;
+    ltx::list<double, Alloc> b;
+    for(int i=0; i<N; ++i)
+    {
+        a.push_back(i);
+        b.push_back(i);
+    }
+    // 删除再插入, 打乱节点在内存中的顺序
+    unsigned seed = 1;
+    typename ltx::list<long, Alloc>::iterator it = a.begin();
+    for(int i=0; i<N; ++i, ++it)
+    {
+        seed = seed*1103515245 + 12345;
+        if((seed>>16)%4 == 0)
+        {
+            it = a.erase(it);
+            b.pop_front();
+            a.insert(it, i);
+            b.push_back(i);
+            --it;
+        }
+    }
+
+    auto begin = chrono::steady_clock::now();
+    long sum = 0;
+    for(int r=0; r<ROUNDS; ++r)
+    {
+        for(typename ltx::list<long, Alloc>::iterator i=a.begin(); i!=a.end(); ++i)
+            sum += *i;
+    }
+    auto end = chrono::steady_clock::now();
+    double ns = chrono::duration<double, nano>(end-begin).count() / (double(N)*ROUNDS);
+    cout << name << ": " << ns << " ns/node (sum " << sum << ")" << endl;
+    return ns;
+}
+
+int main()
+{
+    double d = bench<ltx::default_alloc>("default_alloc");
+    double s = bench<ltx::slab_alloc>("slab_alloc");
+    cout << "speedup: " << d/s << endl;
+    cout << "list<long> slabs: " << ltx::slab_pool<ltx::__list_node<long> >::slabs()
+         << " x " << ltx::slab_pool<ltx::__list_node<long> >::slab_size() << " bytes" << endl;
+
+    // rb_tree节点同样来自按节点类型划分的slab
+    ltx::set<int, less<int>, ltx::slab_alloc> st;
+    for(int i=0; i<1000; ++i) st.insert(i*7%1000);
+    int n = 0;
+    for(ltx::set<int, less<int>, ltx::slab_alloc>::iterator i=st.begin(); i!=st.end(); ++i) ++n;
+    cout << "set: " << n << " " << *st.begin() << endl;
+    return 0;
+}
@@ -0,0 +1,93 @@
+// small_vector: 元素不超过N个时不配置空间
+// 模拟每条记录一个1~8个元素的列表, 比较vector和small_vector的配置次数和耗时
+#define LTX_ALLOC_STATS
+#include "../small_vector.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <type_traits>
+using namespace std;
+
+size_t allocations()
+{
+    ltx::alloc_stats s = ltx::default_alloc::stats();
+    size_t n = s.large_allocations;
+    for(int i=0; i<ltx::__NFREELISTS; ++i) n += s.classes[i].allocations;
+    return n;
+}
+
+template <typename List>
+void bench(const char * name)
+{
+    const int RECORDS = 100000;
+    const int ROUNDS = 20;
+    size_t before = allocations();
+    auto begin = chrono::steady_clock::now();
+    long sum = 0;
+    for(int r=0; r<ROUNDS; ++r)
+    {
+        ltx::vector<List> records;
+        records.reserve(RECORDS);
+        for(int i=0; i<RECORDS; ++i)
+        {
+            records.emplace_back();
+            List & l = records.back();
+            for(int j=0; j<=i%8; ++j) l.push_back(j);
+        }
+        for(int i=0; i<RECORDS; ++i) sum += records[i].back();
+    }
+    auto end = chrono::steady_clock::now();
+    cout << name << ": " << chrono::duration<double, milli>(end-begin).count() << " ms, "
+         << allocations()-before << " allocations, sum " << sum << endl;
+}
+
+template <typename V>
+void print(const char * name, const V & v)
+{
+    cout << name << ":";
+    for(size_t i=0; i<v.size(); ++i) cout << " " << v[i];
+    cout << " (size " << v.size() << ", capacity " << v.capacity() 
+         << ", inline " << v.is_inline() << ")" << endl;
+}
+
+// 只能通过small_vector自己的复制, 移动和交换操作, 不能转换成vector&
+static_assert(!std::is_convertible<ltx::small_vector<int, 8>*, ltx::vector<int, ltx::small_buffer_alloc<int, 8> >*>::value,
+              "private base");
+static_assert(std::is_nothrow_move_constructible<ltx::small_vector<string, 4> >::value, "move");
+static_assert(std::is_nothrow_move_assignable<ltx::small_vector<string, 4> >::value, "move assign");
+
+int main()
+{
+    bench<ltx::vector<int> >("vector<int>");
+    bench<ltx::small_vector<int, 8> >("small_vector<int, 8>");
+
+    // 超出N后转到堆上, shrink_to_fit后回到对象内部
+    ltx::small_vector<string, 4> a;
+    for(int i=0; i<3; ++i) a.push_back(to_string(i));
+    print("a", a);
+    a.insert(a.begin()+1, 3, string("x"));
+    print("a", a);
+    a.erase(a.begin()+1, a.begin()+4);
+    a.shrink_to_fit();
+    print("a", a);
+
+    // 复制, 移动, 交换
+    ltx::small_vector<string, 4> b(a);
+    b.push_back("3");
+    print("b", b);
+    ltx::small_vector<string, 4> c(6, string("c"));
+    ltx::small_vector<string, 4> d(std::move(c));
+    print("c", c);
+    print("d", d);
+    b.swap(d);
+    print("b", b);
+    print("d", d);
+    d = b;
+    print("d", d);
+    a = std::move(b);
+    print("a", a);
+    print("b", b);
+    b = std::move(d);
+    print("b", b);
+    return 0;
+}
@@ -0,0 +1,52 @@
+// thread_alloc的多线程扩展性
+// 1, 2, 4 ... 个线程(至少到hardware_concurrency)各自反复配置/释放8~128字节的区块,
+// 比较thread_alloc和base_alloc(operator new)的总吞吐量
+#include "../stl_thread_alloc.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+using namespace std;
+
+const int ROUNDS = 200;
+const int BLOCKS = 1000;
+
+template <typename Alloc>
+void worker()
+{
+    vector<void*> p(BLOCKS);
+    for(int r=0; r<ROUNDS; ++r)
+    {
+        for(int i=0; i<BLOCKS; ++i) p[i] = Alloc::allocate(8 + (i%16)*8);
+        for(int i=0; i<BLOCKS; ++i) Alloc::deallocate(p[i], 8 + (i%16)*8);
+    }
+}
+
+// 返回所有线程合计的 百万次配置+释放/秒
+template <typename Alloc>
+double run(int threads)
+{
+    auto begin = chrono::steady_clock::now();
+    vector<thread> ts;
+    for(int i=0; i<threads; ++i) ts.push_back(thread(worker<Alloc>));
+    for(auto & t : ts) t.join();
+    auto end = chrono::steady_clock::now();
+    double sec = chrono::duration<double>(end-begin).count();
+    return double(threads) * ROUNDS * BLOCKS / sec / 1e6;
+}
+
+int main()
+{
+    int hc = thread::hardware_concurrency();
+    if(hc < 4) hc = 4;
+    cout << "hardware_concurrency: " << thread::hardware_concurrency() << endl;
+    run<ltx::thread_alloc>(1);
+    double base1 = run<ltx::thread_alloc>(1);
+    for(int t=1; t<=hc; t*=2)
+    {
+        double a = run<ltx::thread_alloc>(t);
+        double b = run<ltx::base_alloc>(t);
+        cout << t << " threads: thread_alloc " << a << " M/s (x" << a/base1 << "), base_alloc " << b << " M/s" << endl;
+    }
+    return 0;
+}
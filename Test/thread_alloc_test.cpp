@@ -0,0 +1,87 @@
+#include "../stl_thread_alloc.h"
+#include "../map.h"
+#include "../list.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <cassert>
+using namespace std;
+
+typedef ltx::map<int, int, less<int>, ltx::thread_alloc> tmap;
+typedef ltx::list<int, ltx::thread_alloc> tlist;
+
+// 每个线程各自往map和list中插入元素
+void worker(int n)
+{
+    tmap mp;
+    tlist l;
+    for(int i=0; i<n; ++i)
+    {
+        if(i%64 == 0) mp[(i*2654435761u)%n] = i;
+        l.push_back(i);
+    }
+}
+
+// 先于线程缓存构造, 线程退出时在线程缓存析构之后配置和释放区块
+struct exit_user
+{
+    void * p;
+    exit_user() : p(nullptr) {}
+    ~exit_user()
+    {
+        void * q = ltx::thread_alloc::allocate(72);
+        ltx::thread_alloc::deallocate(q, 72);
+        ltx::thread_alloc::deallocate(p, 72);
+        freed = p;
+    }
+    static void * freed;
+};
+void * exit_user::freed = nullptr;
+
+double run(int threads, int n)
+{
+    auto begin = chrono::steady_clock::now();
+    vector<thread> ts;
+    for(int i=0; i<threads; ++i) ts.push_back(thread(worker, n));
+    for(auto & t : ts) t.join();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end-begin).count();
+}
+
+int main()
+{
+    // 生产者配置区块, 消费者释放
+    const int N = 100000;
+    vector<void*> blocks(N);
+    thread producer([&]() {
+        for(int i=0; i<N; ++i) blocks[i] = ltx::thread_alloc::allocate(24);
+    });
+    producer.join();
+    thread consumer([&]() {
+        for(int i=0; i<N; ++i) ltx::thread_alloc::deallocate(blocks[i], 24);
+    });
+    consumer.join();
+    // 消费者还给中心仓库的区块可以被其他线程再次使用
+    for(int i=0; i<N; ++i) blocks[i] = ltx::thread_alloc::allocate(24);
+    for(int i=0; i<N; ++i) ltx::thread_alloc::deallocate(blocks[i], 24);
+    cout << "producer/consumer ok" << endl;
+
+    // 线程缓存析构后释放的区块直接还给中心仓库, 其他线程可以取到
+    thread([]() {
+        static thread_local exit_user u;
+        u.p = ltx::thread_alloc::allocate(72);
+    }).join();
+    void * reused = ltx::thread_alloc::allocate(72);
+    assert(reused == exit_user::freed);
+    ltx::thread_alloc::deallocate(reused, 72);
+    cout << "thread exit ok" << endl;
+
+    int hc = thread::hardware_concurrency();
+    if(hc < 4) hc = 4;
+    for(int t=1; t<=hc; t*=2)
+    {
+        cout << t << " threads: " << run(t, 100000) << " ms" << endl;
+    }
+    return 0;
+}
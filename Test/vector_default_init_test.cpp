@@ -0,0 +1,48 @@
+// resize_default_init / append_uninitialized: 新增的元素不写入任何值
+// 用mmap_alloc配置256MB的vector<char>, 比较resize和resize_default_init的耗时和实际占用的物理内存
+#include "../stl_mmap_alloc.h"
+#include "../vector.h"
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+using namespace std;
+
+// 当前进程占用的物理内存(MB)
+long rss_mb()
+{
+    long pages = 0, resident = 0;
+    FILE * f = fopen("/proc/self/statm", "r");
+    if(f == nullptr) return -1;
+    if(fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(f);
+    return resident * 4096 / (1024*1024);
+}
+
+template <bool DefaultInit>
+void grow(const char * name, size_t n)
+{
+    long before = rss_mb();
+    auto begin = chrono::steady_clock::now();
+    ltx::vector<char, ltx::mmap_alloc<> > buf;
+    if(DefaultInit) buf.resize_default_init(n);
+    else buf.resize(n);
+    auto end = chrono::steady_clock::now();
+    cout << name << ": " << chrono::duration<double, milli>(end-begin).count() << " ms, "
+         << "size " << buf.size()/(1024*1024) << " MB, rss +" << rss_mb()-before << " MB" << endl;
+}
+
+int main()
+{
+    const size_t N = 256*1024*1024;
+    grow<true>("resize_default_init", N);
+    grow<false>("resize", N);
+
+    // 追加一段之后由调用者填充
+    ltx::vector<int> v(3, 7);
+    int * p = v.append_uninitialized(4);
+    for(int i=0; i<4; ++i) p[i] = i;
+    v.resize_default_init(5);
+    for(size_t i=0; i<v.size(); ++i) cout << v[i] << " ";
+    cout << endl << "size " << v.size() << " capacity " << v.capacity() << endl;
+    return 0;
+}
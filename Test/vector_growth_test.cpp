@@ -0,0 +1,53 @@
+#include "../vector.h"
+#include <iostream>
+#include <string>
+using namespace std;
+
+// 打印push_back过程中容量的变化
+template <typename Vector>
+void print_growth(const char * name, int n)
+{
+    Vector v;
+    size_t cap = v.capacity();
+    cout << name << ":";
+    for(int i=0; i<n; ++i)
+    {
+        v.push_back(typename Vector::value_type());
+        if(v.capacity() != cap)
+        {
+            cap = v.capacity();
+            cout << " " << cap;
+        }
+    }
+    cout << endl;
+}
+
+int main()
+{
+    print_growth<ltx::vector<int> >("double", 100);
+    print_growth<ltx::vector<int, ltx::alloc, ltx::grow_one_half> >("1.5x", 100);
+    print_growth<ltx::vector<double, ltx::alloc, ltx::grow_page<> > >("page", 3000);
+
+    // reserve之后不再重新配置
+    ltx::vector<string> v;
+    v.reserve(100);
+    string * p = &*v.begin();
+    for(int i=0; i<100; ++i) v.push_back(to_string(i));
+    cout << "reserve: " << v.capacity() << " " << (p == &*v.begin()) << " " << v[99] << endl;
+
+    // shrink_to_fit
+    v.erase(v.begin()+10, v.end());
+    v.shrink_to_fit();
+    cout << "shrink_to_fit: " << v.size() << " " << v.capacity() << " " << v[9] << endl;
+    v.clear();
+    v.shrink_to_fit();
+    cout << "empty: " << v.capacity() << endl;
+
+    // 插入的元素多于原长度时, 新容量至少为旧长度+n
+    ltx::vector<int> w(3, 1);
+    w.insert(w.begin()+1, 10, 2);
+    w.insert(w.end(), 2, w[0]);
+    for(size_t i=0; i<w.size(); ++i) cout << w[i] << " ";
+    cout << endl << "size " << w.size() << " capacity " << w.capacity() << endl;
+    return 0;
+}
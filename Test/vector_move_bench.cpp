@@ -0,0 +1,66 @@
+// vector的移动语义
+// 重新配置时, 移动构造不抛异常的元素(std::string)被移动; 移动可能抛异常的元素只能复制
+#include "../vector.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <type_traits>
+using namespace std;
+
+// 和std::string相同, 但移动构造没有声明noexcept, 重新配置时只能复制
+struct throwing_move_string
+{
+    string s;
+    throwing_move_string(const string & x) : s(x) {}
+    throwing_move_string(const throwing_move_string & x) : s(x.s) {}
+    throwing_move_string(throwing_move_string && x) noexcept(false) : s(std::move(x.s)) {}
+    throwing_move_string & operator=(const throwing_move_string & x) { s = x.s; return *this; }
+    throwing_move_string & operator=(throwing_move_string && x) { s = std::move(x.s); return *this; }
+};
+
+// 移动构造不抛异常, 外层vector增长时嵌套的vector直接移动而不是深复制
+static_assert(std::is_nothrow_move_constructible<ltx::vector<int> >::value, "vector move");
+static_assert(std::is_nothrow_move_assignable<ltx::vector<int> >::value, "vector move assign");
+static_assert(std::is_nothrow_move_constructible<ltx::vector<bool> >::value, "bvector move");
+
+template <typename T>
+double grow(const char * name, int n)
+{
+    const string value(64, 'x');
+    auto begin = chrono::steady_clock::now();
+    ltx::vector<T> v;
+    for(int i=0; i<n; ++i) v.emplace_back(value);
+    auto end = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(end-begin).count();
+    cout << name << ": " << ms << " ms" << endl;
+    return ms;
+}
+
+int main()
+{
+    const int N = 1000000;
+    double copy_ms = grow<throwing_move_string>("grow, copy on reallocation", N);
+    double move_ms = grow<string>("grow, move on reallocation", N);
+    cout << "speedup: " << copy_ms/move_ms << endl;
+
+    // emplace, insert和erase
+    ltx::vector<string> v;
+    v.emplace_back(3, 'a');
+    v.push_back(string("ccc"));
+    v.emplace(v.begin()+1, "bbb");
+    v.insert(v.begin(), v[2]);      // 引用自身的元素
+    v.erase(v.begin()+1);
+    for(size_t i=0; i<v.size(); ++i) cout << v[i] << " ";
+    cout << endl;
+
+    // 整个vector的移动是O(1)的
+    ltx::vector<string> big(N, string(64, 'y'));
+    auto begin = chrono::steady_clock::now();
+    ltx::vector<string> moved(std::move(big));
+    ltx::vector<string> assigned;
+    assigned = std::move(moved);
+    auto end = chrono::steady_clock::now();
+    cout << "move " << assigned.size() << " strings: "
+         << chrono::duration<double, micro>(end-begin).count() << " us, source size " << big.size() << endl;
+    return 0;
+}
@@ -0,0 +1,74 @@
+// vector通过配置器的reallocate原地扩展
+// mmap_alloc提供reallocate, 大缓冲区用mremap扩展, 不复制数据, 也不会新旧两块空间同时存在
+// copy_alloc同样使用mmap_alloc, 但没有reallocate, 每次重新配置都复制全部元素
+// 两者交替运行几轮(第一轮含有首次访问物理内存的开销), 比较耗时和同时持有的最大字节数
+#include "../stl_mmap_alloc.h"
+#include "../vector.h"
+#include <iostream>
+#include <chrono>
+using namespace std;
+
+typedef ltx::mmap_alloc<> mmap_alloc;
+
+// 记录当前持有的字节数和最大值
+size_t in_use = 0;
+size_t peak = 0;
+void add_in_use(long n)
+{
+    in_use += n;
+    if(in_use > peak) peak = in_use;
+}
+
+struct remap_alloc
+{
+    static void * allocate(size_t n) { add_in_use(n); return mmap_alloc::allocate(n); }
+    static void deallocate(void * p, size_t n) { in_use -= n; mmap_alloc::deallocate(p, n); }
+    static void * reallocate(void * p, size_t old_sz, size_t new_sz)
+    {
+        add_in_use(long(new_sz) - long(old_sz));
+        return mmap_alloc::reallocate(p, old_sz, new_sz);
+    }
+};
+
+struct copy_alloc
+{
+    static void * allocate(size_t n) { add_in_use(n); return mmap_alloc::allocate(n); }
+    static void deallocate(void * p, size_t n) { in_use -= n; mmap_alloc::deallocate(p, n); }
+};
+
+template <typename Alloc>
+void ingest(const char * name, long n)
+{
+    peak = in_use = 0;
+    auto begin = chrono::steady_clock::now();
+    {
+        ltx::vector<long, Alloc> v;
+        for(long i=0; i<n; ++i) v.push_back(i);
+    }
+    auto end = chrono::steady_clock::now();
+    cout << name << ": reallocate hook " << ltx::has_reallocate<Alloc>::value
+         << ", " << chrono::duration<double, milli>(end-begin).count() << " ms"
+         << ", data " << n*sizeof(long)/(1024*1024) << " MB"
+         << ", peak " << peak/(1024*1024) << " MB" << endl;
+}
+
+int main()
+{
+    const long N = 32*1024*1024;
+    for(int round=0; round<3; ++round)
+    {
+        ingest<copy_alloc>("copy", N);
+        ingest<remap_alloc>("mremap", N);
+    }
+
+    // reserve, shrink_to_fit和中间插入同样走reallocate
+    ltx::vector<int, mmap_alloc> v(1000000, 1);
+    v.insert(v.begin()+10, 3000000, 2);
+    v.reserve(8000000);
+    v.shrink_to_fit();
+    cout << v.size() << " " << v.capacity() << " " << v[9] << v[10] << v[3000009] << v[3000010] << endl;
+    v.push_back(3);
+    v.insert(v.begin(), v[3000010]);
+    cout << v.size() << " " << v[0] << v.back() << endl;
+    return 0;
+}
@@ -1,18 +1,43 @@
 #ifndef DEQUE_H
 #define DEQUE_H
 
-
+#include <cstring>
 #include "memory.h"
 #include "stl_iterator.h"
+#include "stl_algobase.h"
+#include "stl_numeric.h"
 
 namespace ltx
 {
-    // n不为0, 使用用户自定义的值, 否则如果元素大小大于等于512, 为1, 否则为512/sizeof(T)
-    inline size_t __dequeue_buf_size(size_t n, size_t sz)
+    // 缓冲区大小的默认值: 不超过LTX_DEQUE_BUF_BYTES字节能放下的元素个数, 但至少LTX_DEQUE_MIN_ELEMS个
+    // 可在包含本文件前定义这两个宏; 大元素至少有几个放在一起, 遍历时不会每一步都切换缓冲区
+#ifndef LTX_DEQUE_BUF_BYTES
+#define LTX_DEQUE_BUF_BYTES 512
+#endif
+#ifndef LTX_DEQUE_MIN_ELEMS
+#define LTX_DEQUE_MIN_ELEMS 8
+#endif
+
+    constexpr size_t __deque_buf_elems(size_t sz, size_t bytes, size_t min_elems)
+    {
+        return bytes/sz > min_elems ? bytes/sz : (min_elems != 0 ? min_elems : 1);
+    }
+
+    // n不为0, 使用用户自定义的值, 否则使用默认值
+    constexpr size_t __dequeue_buf_size(size_t n, size_t sz)
     {
-        return n!=0 ? n : (sz<512 ? size_t(512/sz) : size_t(1));
+        return n!=0 ? n : __deque_buf_elems(sz, LTX_DEQUE_BUF_BYTES, LTX_DEQUE_MIN_ELEMS);
     }
 
+    // 按字节预算决定缓冲区大小, 作为deque的BufSiz参数使用, 例如
+    //   deque<T, alloc, deque_buf_elems<T, 4096>::value>
+    // 每个缓冲区不超过Bytes字节(至少MinElems个元素); 和align_alloc<4096>一起使用时缓冲区按页对齐
+    template <typename T, size_t Bytes, size_t MinElems = 1>
+    struct deque_buf_elems
+    {
+        static const size_t value = __deque_buf_elems(sizeof(T), Bytes, MinElems);
+    };
+
     template <typename T, typename Ref, typename Ptr, size_t BufSiz>
     struct __deque_iterator
     {
@@ -57,6 +82,8 @@ namespace ltx
 
         difference_type operator-(const self& x) const
         {
+            // 同一缓冲区直接相减, 被移走的deque两端都是空迭代器, 也由这里得到0
+            if (node == x.node) return cur - x.cur;
             return difference_type(buffer_size()) * (node - x.node - 1) +
                 (cur - first) + (x.last - x.cur);
         }
@@ -140,8 +167,101 @@ namespace ltx
         bool operator>=(const self& x) const { return !(*this < x); }
     };
 
+    // deque的迭代器是分段迭代器, 每个缓冲区是一段
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz>
+    struct segmented_iterator_traits<__deque_iterator<T, Ref, Ptr, BufSiz> >
+    {
+        static const bool is_segmented = true;
+        typedef __deque_iterator<T, Ref, Ptr, BufSiz> iterator;
+        typedef T** segment_iterator;
+        typedef Ptr local_iterator;
+
+        static segment_iterator segment(const iterator& it) { return it.node; }
+        static local_iterator local(const iterator& it) { return it.cur; }
+        static local_iterator begin(segment_iterator s) { return *s; }
+        static local_iterator end(segment_iterator s) { return *s + iterator::buffer_size(); }
+        static iterator compose(segment_iterator s, local_iterator l)
+        {
+            // 迭代器不会停在缓冲区尾部
+            if(l == end(s))
+            {
+                ++s;
+                l = begin(s);
+            }
+            iterator result;
+            result.set_node(s);
+            result.cur = const_cast<T*>(l);
+            return result;
+        }
+    };
+
+    // 以下算法比标准库的版本更特殊, 参数是deque的迭代器时会被选中
+    // 区间被拆成各个缓冲区中的连续空间, 每段用指针处理, 不再每一步都检查是否到了缓冲区尾部
+
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz, typename OutputIterator>
+    inline OutputIterator copy(__deque_iterator<T, Ref, Ptr, BufSiz> first,
+                               __deque_iterator<T, Ref, Ptr, BufSiz> last, OutputIterator result)
+    {
+        return __segmented_copy(first, last, result);
+    }
+
+    template <typename U, typename T, size_t BufSiz>
+    inline __deque_iterator<T, T&, T*, BufSiz> copy(U * first, U * last, __deque_iterator<T, T&, T*, BufSiz> result)
+    {
+        return __copy_to_segmented(first, last, result);
+    }
+
+    template <typename T, size_t BufSiz, typename V>
+    inline void fill(__deque_iterator<T, T&, T*, BufSiz> first, __deque_iterator<T, T&, T*, BufSiz> last,
+                     const V& value)
+    {
+        __segmented_fill(first, last, value);
+    }
+
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz, typename V>
+    inline __deque_iterator<T, Ref, Ptr, BufSiz> find(__deque_iterator<T, Ref, Ptr, BufSiz> first,
+                                                      __deque_iterator<T, Ref, Ptr, BufSiz> last, const V& value)
+    {
+        return __segmented_find(first, last, value);
+    }
+
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz, typename Function>
+    inline Function for_each(__deque_iterator<T, Ref, Ptr, BufSiz> first,
+                             __deque_iterator<T, Ref, Ptr, BufSiz> last, Function f)
+    {
+        return __segmented_for_each(first, last, f);
+    }
+
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz, typename V>
+    inline V accumulate(__deque_iterator<T, Ref, Ptr, BufSiz> first,
+                        __deque_iterator<T, Ref, Ptr, BufSiz> last, V init)
+    {
+        return __segmented_accumulate(first, last, init);
+    }
+
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz, typename V, typename BinaryOperation>
+    inline V accumulate(__deque_iterator<T, Ref, Ptr, BufSiz> first,
+                        __deque_iterator<T, Ref, Ptr, BufSiz> last, V init, BinaryOperation binary_op)
+    {
+        return __segmented_accumulate(first, last, init, binary_op);
+    }
+
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz, typename ForwardIterator>
+    inline ForwardIterator uninitialized_copy(__deque_iterator<T, Ref, Ptr, BufSiz> first,
+                                              __deque_iterator<T, Ref, Ptr, BufSiz> last, ForwardIterator result)
+    {
+        return __segmented_uninitialized_copy(first, last, result);
+    }
+
+    template <typename U, typename T, size_t BufSiz>
+    inline __deque_iterator<T, T&, T*, BufSiz> uninitialized_copy(U * first, U * last,
+                                                                  __deque_iterator<T, T&, T*, BufSiz> result)
+    {
+        return __uninitialized_copy_to_segmented(first, last, result);
+    }
+
     template <typename T, typename Alloc=alloc, size_t BufSiz=0>
-    class deque
+    class deque : protected alloc_holder<Alloc>
     {
     public:
         typedef T value_type;
@@ -153,6 +273,7 @@ namespace ltx
     
     public:
         typedef __deque_iterator<T, T&, T*, BufSiz>       iterator;
+        typedef __deque_iterator<T, const T&, const T*, BufSiz> const_iterator;
     
     protected: 
     
@@ -160,6 +281,8 @@ namespace ltx
 
         typedef simple_alloc<value_type, Alloc> data_allocator;
         typedef simple_alloc<pointer, Alloc> map_allocator;
+        typedef alloc_holder<Alloc> alloc_base;
+        using alloc_base::get_alloc;
     
         // 缓冲区大小
         static size_type buffer_size()
@@ -169,17 +292,28 @@ namespace ltx
         }
     
         static size_type initial_map_size() { return 8; }
+
+        // 最多缓存的空闲缓冲区个数
+        // 元素离开一个缓冲区时先把它留作备用, 需要新缓冲区时先取备用的,
+        // 队列式的使用(一端进一端出)在稳定状态下不再配置和释放缓冲区
+        enum {__SPARE_NODES = 2};
     
     protected:
         iterator start;
         iterator finish;
     
+        // 被移走的deque没有map(map为0, start和finish为空迭代器), 需要插入元素时再配置
         map_pointer map;
         size_type map_size;
+
+        pointer spare[__SPARE_NODES];
+        size_type nspare;
     
     public:
         iterator begin() { return start; }
         iterator end() { return finish; }
+        const_iterator begin() const { return start; }
+        const_iterator end() const { return finish; }
         
         reference operator[](size_type n) { return start[difference_type(n)]; }
     
@@ -198,17 +332,109 @@ namespace ltx
         bool empty() const { return finish == start; }
     
     public:
-        deque() : start(), finish(), map(0), map_size(0)
+        deque() : start(), finish(), map(0), map_size(0), nspare(0)
         {
             create_map_and_nodes(0);
         }
 
+        explicit deque(const Alloc& a) 
+            : alloc_base(a), start(), finish(), map(0), map_size(0), nspare(0)
+        {
+            create_map_and_nodes(0);
+        }
+
+        deque(size_type n, const value_type& value, const Alloc& a = Alloc())
+            : alloc_base(a), start(), finish(), map(0), map_size(0), nspare(0)
+        {
+            fill_initialize(n, value);
+        }
+
+        explicit deque(size_type n, const Alloc& a = Alloc())
+            : alloc_base(a), start(), finish(), map(0), map_size(0), nspare(0)
+        {
+            fill_initialize(n, value_type());
+        }
+
+        // 前向迭代器的区间一次配置好全部缓冲区; 两个参数都是整数时等同于deque(n, value)
+        template <typename InputIterator>
+        deque(InputIterator first, InputIterator last, const Alloc& a = Alloc())
+            : alloc_base(a), start(), finish(), map(0), map_size(0), nspare(0)
+        {
+            initialize_dispatch(first, last, std::is_integral<InputIterator>());
+        }
+
+        // 复制和移动都会连同配置器一起传播
+        deque(const deque<T, Alloc, BufSiz>& x)
+            : alloc_base(x.get_alloc()), start(), finish(), map(0), map_size(0), nspare(0)
+        {
+            create_map_and_nodes(x.size());
+            try
+            {
+                uninitialized_copy(x.begin(), x.end(), start);
+            }
+            catch(...)
+            {
+                destroy_map_and_nodes();
+                throw;
+            }
+        }
+
+        // 接管x的map, x成为没有map的空deque
+        deque(deque<T, Alloc, BufSiz>&& x) noexcept
+            : alloc_base(x.get_alloc()), start(), finish(), map(0), map_size(0), nspare(0)
+        {
+            swap_data(x);
+        }
+
         ~deque()
         {
             _destroy(start, finish);
             destroy_map_and_nodes();
         }
 
+        deque<T, Alloc, BufSiz>& operator=(const deque<T, Alloc, BufSiz>& x)
+        {
+            if (this == &x) return *this;
+            if (!this->same_alloc(x))
+            {
+                // 配置器不同, 先用原配置器释放全部空间, 之后的插入用新配置器配置map
+                clear();
+                destroy_map_and_nodes();
+                get_alloc() = x.get_alloc();
+            }
+            const size_type len = size();
+            if (len >= x.size())
+                erase(copy(x.begin(), x.end(), start), finish);
+            else 
+            {
+                const_iterator mid = x.begin() + difference_type(len);
+                copy(x.begin(), mid, start);
+                append(mid, x.end());
+            }
+            return *this;
+        }
+
+        deque<T, Alloc, BufSiz>& operator=(deque<T, Alloc, BufSiz>&& x) noexcept
+        {
+            if (this == &x) return *this;
+            clear();
+            destroy_map_and_nodes();
+            get_alloc() = x.get_alloc();
+            swap_data(x);
+            return *this;
+        }
+
+        void swap(deque<T, Alloc, BufSiz>& x) noexcept
+        {
+            swap_data(x);
+            this->swap_alloc(x);
+        }
+
+        Alloc get_allocator() const { return get_alloc(); }
+
+        // 释放备用的缓冲区
+        void shrink_to_fit() { free_spare(); }
+
     
     protected:
     // 元素构造析构分配释放系列
@@ -237,11 +463,23 @@ namespace ltx
 
         map_pointer allocate_map(size_type n) 
         {
-            return map_allocator::allocate(n); 
+            return map_allocator::allocate(get_alloc(), n); 
         }
         void deallocate_map(map_pointer p, size_type n) 
         {
-            map_allocator::deallocate(p, n); 
+            map_allocator::deallocate(get_alloc(), p, n); 
+        }
+
+        // 只交换元素, 不交换配置器
+        void swap_data(deque<T, Alloc, BufSiz>& x)
+        {
+            std::swap(start, x.start);
+            std::swap(finish, x.finish);
+            std::swap(map, x.map);
+            std::swap(map_size, x.map_size);
+            for (size_type i = 0; i < size_type(__SPARE_NODES); ++i)
+                std::swap(spare[i], x.spare[i]);
+            std::swap(nspare, x.nspare);
         }
 
 
@@ -250,7 +488,7 @@ namespace ltx
             size_type num_nodes = num_elements / buffer_size() + 1;
             map_size = max(initial_map_size(), num_nodes + 2);
             
-            map = map_allocator::allocate(map_size);
+            map = allocate_map(map_size);
             
             // 令nstart和nfinish指向map中间区段
             map_pointer nstart = map + (map_size - num_nodes) / 2;
@@ -267,7 +505,9 @@ namespace ltx
             {
                 for (map_pointer n = nstart; n < cur; ++n)
                     deallocate_node(*n);
-                map_allocator::deallocate(map, map_size);
+                deallocate_map(map, map_size);
+                map = 0;
+                map_size = 0;
                 throw;
             }
             
@@ -278,21 +518,48 @@ namespace ltx
         }
 
 
+        // 释放后回到没有map的状态
         void destroy_map_and_nodes()
         {
-            for (map_pointer cur = start.node; cur <= finish.node; ++cur)
-                deallocate_node(*cur);
-            map_allocator::deallocate(map, map_size);
+            if (map != 0)
+            {
+                for (map_pointer cur = start.node; cur <= finish.node; ++cur)
+                    deallocate_node(*cur);
+                deallocate_map(map, map_size);
+                map = 0;
+                map_size = 0;
+                start = finish = iterator();
+            }
+            free_spare();
+        }
+
+        // 没有map时配置一个空的map
+        void ensure_map()
+        {
+            if (map == 0) create_map_and_nodes(0);
         }
 
         value_type* allocate_node()
         {
-            return data_allocator::allocate(buffer_size());
+            if (nspare != 0) return spare[--nspare];
+            return data_allocator::allocate(get_alloc(), buffer_size());
+        }
+
+        // 不再使用的缓冲区, 备用数量未满时留作备用
+        void release_node(pointer n)
+        {
+            if (nspare < size_type(__SPARE_NODES)) spare[nspare++] = n;
+            else deallocate_node(n);
+        }
+
+        void free_spare()
+        {
+            while (nspare != 0) deallocate_node(spare[--nspare]);
         }
 
         void deallocate_node(pointer n)
         {
-            data_allocator::deallocate(n, buffer_size());
+            data_allocator::deallocate(get_alloc(), n, buffer_size());
         }
 
         void destroy_nodes(map_pointer nstart, map_pointer nfinish)
@@ -304,27 +571,62 @@ namespace ltx
     public:
     // 接口
 
-        void push_back(const value_type & t)
+        void push_back(const value_type & t) { emplace_back(t); }
+        void push_back(value_type&& t) { emplace_back(std::move(t)); }
+        void push_front(const value_type& t) { emplace_front(t); }
+        void push_front(value_type&& t) { emplace_front(std::move(t)); }
+
+        // 缓冲区不会移动, args引用deque中的元素也没有问题
+        template <typename... Args>
+        void emplace_back(Args&&... args)
         {
-            // 如果最后一个缓冲区还有空间
-            if(finish.cur != finish.last-1)
+            // 如果最后一个缓冲区还有空间, 没有map时last和cur都为0, 进入push_back_aux
+            if(finish.last - finish.cur > 1)
             {
-                _construct(finish.cur, t);
+                _construct(finish.cur, std::forward<Args>(args)...);
                 ++finish.cur;
             }
             else
-                push_back_aux(t);
+                push_back_aux(std::forward<Args>(args)...);
         }
 
-        void push_front(const value_type& t)
+        template <typename... Args>
+        void emplace_front(Args&&... args)
         {
             if (start.cur != start.first) 
             {
-                _construct(start.cur - 1, t);
+                _construct(start.cur - 1, std::forward<Args>(args)...);
                 --start.cur;
             } 
             else
-                push_front_aux(t);
+                push_front_aux(std::forward<Args>(args)...);
+        }
+
+        // 在尾部追加区间[first, last), 前向迭代器的区间先一次配置好需要的缓冲区
+        template <typename InputIterator>
+        void append(InputIterator first, InputIterator last)
+        {
+            insert(finish, first, last);
+        }
+
+        void assign(size_type n, const value_type& x)
+        {
+            if (n > size())
+            {
+                fill(start, finish, x);
+                insert(finish, n - size(), x);
+            }
+            else
+            {
+                erase(start + difference_type(n), finish);
+                fill(start, finish, x);
+            }
+        }
+
+        template <typename InputIterator>
+        void assign(InputIterator first, InputIterator last)
+        {
+            assign_dispatch(first, last, std::is_integral<InputIterator>());
         }
         
         void pop_back()
@@ -368,14 +670,62 @@ namespace ltx
             }
             else 
             {
-                return insert_aux(position, x);
+                return emplace_aux(position, x);
             }
         }
         
+        iterator insert(iterator position, value_type&& x)
+        {
+            if (position.cur == start.cur) 
+            {
+                push_front(std::move(x));
+                return start;
+            }
+            else if (position.cur == finish.cur) 
+            {
+                push_back(std::move(x));
+                iterator tmp = finish;
+                --tmp;
+                return tmp;
+            }
+            else 
+            {
+                return emplace_aux(position, std::move(x));
+            }
+        }
+
+        template <typename... Args>
+        iterator emplace(iterator position, Args&&... args)
+        {
+            if (position.cur == start.cur) 
+            {
+                emplace_front(std::forward<Args>(args)...);
+                return start;
+            }
+            else if (position.cur == finish.cur) 
+            {
+                emplace_back(std::forward<Args>(args)...);
+                iterator tmp = finish;
+                --tmp;
+                return tmp;
+            }
+            else 
+            {
+                return emplace_aux(position, std::forward<Args>(args)...);
+            }
+        }
+
         iterator insert(iterator position) 
         { 
             return insert(position, value_type()); 
         }
+
+        // 两个参数都是整数时等同于insert(pos, n, x)
+        template <typename InputIterator>
+        void insert(iterator pos, InputIterator first, InputIterator last)
+        {
+            insert_dispatch(pos, first, last, std::is_integral<InputIterator>());
+        }
         
         
         void insert(iterator pos, size_type n, const value_type& x)
@@ -457,7 +807,7 @@ namespace ltx
                 _destroy(start, new_start); //移动完毕，将冗余元素析构
                 //将冗余缓冲区释放
                 for (map_pointer cur = start.node; cur < new_start.node; ++cur)
-                    data_allocator::deallocate(*cur, buffer_size());
+                    release_node(*cur);
                 start = new_start;  //设定deque新起点
                 }
                 else { //清除区间后方元素少，向前移动后方元素（覆盖清除区）
@@ -465,7 +815,7 @@ namespace ltx
                 iterator new_finish = finish - n;
                 _destroy(new_finish, finish);
                 for (map_pointer cur = new_finish.node + 1; cur <= finish.node; ++cur)
-                    data_allocator::deallocate(*cur, buffer_size());
+                    release_node(*cur);
                 finish = new_finish;
                 }
                 return start + elems_before;
@@ -479,14 +829,14 @@ namespace ltx
                         node < finish.node; ++node) 
             {
                 _destroy(*node, *node + buffer_size());
-                data_allocator::deallocate(*node, buffer_size());
+                release_node(*node);
             }
             
             if (start.node != finish.node) 
             {
                 _destroy(start.cur, start.last); 
                 _destroy(finish.first, finish.cur); 
-                data_allocator::deallocate(finish.first, buffer_size());
+                release_node(finish.first);
             }
             else
                 _destroy(start.cur, finish.cur);
@@ -497,33 +847,42 @@ namespace ltx
     protected:
     // 辅助函数
     
-        void push_back_aux(const value_type& t)
+        template <typename... Args>
+        void push_back_aux(Args&&... args)
         {
-            value_type t_copy = t;
+            if (map == 0)
+            {
+                // 新配置的map最后一个缓冲区是空的, 重新走emplace_back
+                create_map_and_nodes(0);
+                emplace_back(std::forward<Args>(args)...);
+                return ;
+            }
             reserve_map_at_back();
             *(finish.node + 1) = allocate_node();
             try
             {
-                _construct(finish.cur, t_copy);
+                _construct(finish.cur, std::forward<Args>(args)...);
                 finish.set_node(finish.node + 1); 
                 finish.cur = finish.first; 
             }
             catch(...)
             {
-                deallocate_node(*(finish.node + 1));
+                release_node(*(finish.node + 1));
+                throw;
             }
         }
         
-        void push_front_aux(const value_type& t)
+        template <typename... Args>
+        void push_front_aux(Args&&... args)
         {
-            value_type t_copy = t;
+            ensure_map();
             reserve_map_at_front();
             *(start.node - 1) = allocate_node(); 
             try
             {
                 start.set_node(start.node - 1); 
                 start.cur = start.last - 1;
-                _construct(start.cur, t_copy);
+                _construct(start.cur, std::forward<Args>(args)...);
             }
             catch(...) 
             {
@@ -536,7 +895,7 @@ namespace ltx
         
         void pop_back_aux()
         {
-            deallocate_node(finish.first); 
+            release_node(finish.first); 
             finish.set_node(finish.node - 1);
             finish.cur = finish.last - 1;
             _destroy(finish.cur);
@@ -545,19 +904,20 @@ namespace ltx
         void pop_front_aux()
         {
             _destroy(start.cur);
-            deallocate_node(start.first);
+            release_node(start.first);
             start.set_node(start.node + 1);
             start.cur = start.first;
         }
         
         
-        iterator insert_aux(iterator pos, const value_type& x)
+        template <typename... Args>
+        iterator emplace_aux(iterator pos, Args&&... args)
         {
             difference_type index = pos - start; //插入点之前的元素个数
-            value_type x_copy = x;
+            value_type x_copy(std::forward<Args>(args)...);
             
             if (index < size() / 2) {   //如果插入点前元素个数少
-                push_front(front()); //在最前端加入与第一个元素同值的元素
+                push_front(std::move(front())); //在最前端加入第一个元素, 原位置随后被覆盖
                 iterator front1 = start;
                 ++front1;
                 iterator front2 = front1;
@@ -565,18 +925,18 @@ namespace ltx
                 pos = start + index;
                 iterator pos1 = pos;
                 ++pos1;
-                copy(front2, pos1, front1); //元素移动
+                std::move(front2, pos1, front1); //元素移动
             }
             else { //插入点后的元素个数较少
-                push_back(back());  //在尾部插入一个与最后一个元素同值的元素
+                push_back(std::move(back()));  //在尾部加入最后一个元素, 原位置随后被覆盖
                 iterator back1 = finish;
                 --back1;
                 iterator back2 = back1;
                 --back2;
                 pos = start + index;
-                copy_backward(pos, back2, back1); //元素移动
+                std::move_backward(pos, back2, back1); //元素移动
             }
-            *pos = x_copy; //在插入点上设定新值
+            *pos = std::move(x_copy); //在插入点上设定新值
             return pos;
         }
 
@@ -648,6 +1008,241 @@ namespace ltx
 
 
 
+        template <typename Integer>
+        void initialize_dispatch(Integer n, Integer x, std::true_type)
+        {
+            fill_initialize(size_type(n), value_type(x));
+        }
+
+        template <typename InputIterator>
+        void initialize_dispatch(InputIterator first, InputIterator last, std::false_type)
+        {
+            range_initialize(first, last, __is_forward_iterator<InputIterator>());
+        }
+
+        // 输入迭代器只能逐个追加
+        template <typename InputIterator>
+        void range_initialize(InputIterator first, InputIterator last, std::false_type)
+        {
+            create_map_and_nodes(0);
+            try
+            {
+                for (; first != last; ++first) emplace_back(*first);
+            }
+            catch(...)
+            {
+                clear();
+                destroy_map_and_nodes();
+                throw;
+            }
+        }
+
+        template <typename ForwardIterator>
+        void range_initialize(ForwardIterator first, ForwardIterator last, std::true_type)
+        {
+            create_map_and_nodes(__range_length(first, last));
+            try
+            {
+                ltx::uninitialized_copy(first, last, start);
+            }
+            catch(...)
+            {
+                destroy_map_and_nodes();
+                throw;
+            }
+        }
+
+        template <typename Integer>
+        void assign_dispatch(Integer n, Integer x, std::true_type)
+        {
+            assign(size_type(n), value_type(x));
+        }
+
+        template <typename InputIterator>
+        void assign_dispatch(InputIterator first, InputIterator last, std::false_type)
+        {
+            assign_range(first, last, __is_forward_iterator<InputIterator>());
+        }
+
+        template <typename InputIterator>
+        void assign_range(InputIterator first, InputIterator last, std::false_type)
+        {
+            iterator cur = start;
+            for (; first != last && cur != finish; ++first, ++cur)
+                *cur = *first;
+            if (first == last)
+                erase(cur, finish);
+            else
+                insert_range(finish, first, last, std::false_type());
+        }
+
+        // 先覆盖已有的元素, 多出的部分一次追加
+        template <typename ForwardIterator>
+        void assign_range(ForwardIterator first, ForwardIterator last, std::true_type)
+        {
+            const size_type n = __range_length(first, last);
+            if (n > size())
+            {
+                ForwardIterator mid = first;
+                for (size_type i = size(); i > 0; --i) ++mid;
+                ltx::__copy(first, mid, start);
+                insert_range(finish, mid, last, std::true_type());
+            }
+            else
+                erase(ltx::__copy(first, last, start), finish);
+        }
+
+        template <typename Integer>
+        void insert_dispatch(iterator pos, Integer n, Integer x, std::true_type)
+        {
+            insert(pos, size_type(n), value_type(x));
+        }
+
+        template <typename InputIterator>
+        void insert_dispatch(iterator pos, InputIterator first, InputIterator last, std::false_type)
+        {
+            insert_range(pos, first, last, __is_forward_iterator<InputIterator>());
+        }
+
+        // 输入迭代器不能预先知道长度, 尾部逐个追加, 其他位置逐个插入
+        template <typename InputIterator>
+        void insert_range(iterator pos, InputIterator first, InputIterator last, std::false_type)
+        {
+            if (pos.cur == finish.cur)
+            {
+                for (; first != last; ++first) emplace_back(*first);
+                return ;
+            }
+            difference_type index = pos - start;
+            for (; first != last; ++first, ++index)
+                emplace(start + index, *first);
+        }
+
+        // 两端插入时先用reserve_elements_at_front/back配置好全部缓冲区, 再按缓冲区整段构造
+        template <typename ForwardIterator>
+        void insert_range(iterator pos, ForwardIterator first, ForwardIterator last, std::true_type)
+        {
+            const size_type n = __range_length(first, last);
+            if (n == 0) return ;
+            if (pos.cur == start.cur)
+            {
+                iterator new_start = reserve_elements_at_front(n);
+                try
+                {
+                    ltx::uninitialized_copy(first, last, new_start);
+                }
+                catch(...)
+                {
+                    destroy_nodes(new_start.node, start.node);
+                    throw;
+                }
+                start = new_start;
+            }
+            else if (pos.cur == finish.cur)
+            {
+                iterator new_finish = reserve_elements_at_back(n);
+                try
+                {
+                    ltx::uninitialized_copy(first, last, finish);
+                }
+                catch(...)
+                {
+                    destroy_nodes(finish.node + 1, new_finish.node + 1);
+                    throw;
+                }
+                finish = new_finish;
+            }
+            else
+                insert_aux(pos, first, last, n);
+        }
+
+        // 在中间插入n个元素, 移动插入点前后较少的一侧
+        template <typename ForwardIterator>
+        void insert_aux(iterator pos, ForwardIterator first, ForwardIterator last, size_type n)
+        {
+            const difference_type elems_before = pos - start;
+            size_type length = this->size();
+            if (elems_before < difference_type(length / 2))
+            {
+                iterator new_start = reserve_elements_at_front(n);
+                iterator old_start = start;
+                pos = start + elems_before;
+                try
+                {
+                    if (elems_before >= difference_type(n))
+                    {
+                        iterator start_n = start + difference_type(n);
+                        ltx::uninitialized_copy(start, start_n, new_start);
+                        start = new_start;
+                        std::move(start_n, pos, old_start);
+                        ltx::__copy(first, last, pos - difference_type(n));
+                    }
+                    else
+                    {
+                        ForwardIterator mid = first;
+                        for (difference_type i = difference_type(n) - elems_before; i > 0; --i) ++mid;
+                        iterator cur = ltx::uninitialized_copy(start, pos, new_start);
+                        try
+                        {
+                            ltx::uninitialized_copy(first, mid, cur);
+                        }
+                        catch(...)
+                        {
+                            _destroy(new_start, cur);
+                            throw;
+                        }
+                        start = new_start;
+                        ltx::__copy(mid, last, old_start);
+                    }
+                }
+                catch(...)
+                {
+                    destroy_nodes(new_start.node, start.node);
+                    throw;
+                }
+            }
+            else
+            {
+                iterator new_finish = reserve_elements_at_back(n);
+                iterator old_finish = finish;
+                const difference_type elems_after = difference_type(length) - elems_before;
+                pos = finish - elems_after;
+                try
+                {
+                    if (elems_after > difference_type(n))
+                    {
+                        iterator finish_n = finish - difference_type(n);
+                        ltx::uninitialized_copy(finish_n, finish, finish);
+                        finish = new_finish;
+                        std::move_backward(pos, finish_n, old_finish);
+                        ltx::__copy(first, last, pos);
+                    }
+                    else
+                    {
+                        ForwardIterator mid = first;
+                        for (difference_type i = elems_after; i > 0; --i) ++mid;
+                        iterator cur = ltx::uninitialized_copy(mid, last, finish);
+                        try
+                        {
+                            ltx::uninitialized_copy(pos, finish, cur);
+                        }
+                        catch(...)
+                        {
+                            _destroy(finish, cur);
+                            throw;
+                        }
+                        finish = new_finish;
+                        ltx::__copy(first, mid, pos);
+                    }
+                }
+                catch(...)
+                {
+                    destroy_nodes(finish.node + 1, new_finish.node + 1);
+                    throw;
+                }
+            }
+        }
+
         void reserve_map_at_back (size_type nodes_to_add = 1)
         {
             if (nodes_to_add + 1 > map_size - (finish.node - map))
@@ -666,15 +1261,14 @@ namespace ltx
             size_type new_num_nodes = old_num_nodes + nodes_to_add;
 
             map_pointer new_nstart;
+            // 使用的节点不到map的一半时移回map中央, 不重新配置map
+            // 队列式的使用会让节点不断向一端漂移, 这样map的大小保持不变
             if (map_size > 2 * new_num_nodes) 
             {
                 new_nstart = map + (map_size - new_num_nodes) / 2 
                                 + (add_at_front ? nodes_to_add : 0);
-                if (new_nstart < start.node)
-                    copy(start.node, finish.node + 1, new_nstart);
-                else
-                    copy_backward(start.node, finish.node + 1, 
-                                new_nstart + old_num_nodes);
+                // map中是指针, 新旧区间可能重叠, 用一次memmove搬移
+                memmove(new_nstart, start.node, old_num_nodes*sizeof(pointer));
             }
             else 
             {
@@ -684,7 +1278,7 @@ namespace ltx
                 map_pointer new_map = allocate_map(new_map_size);
                 new_nstart = new_map + (new_map_size - new_num_nodes) / 2
                                     + (add_at_front ? nodes_to_add : 0);
-                copy(start.node, finish.node + 1, new_nstart);
+                memcpy(new_nstart, start.node, old_num_nodes*sizeof(pointer));
                 deallocate_map(map, map_size);
 
                 map = new_map;
@@ -698,6 +1292,7 @@ namespace ltx
 
         iterator reserve_elements_at_front(size_type n)
         {
+            ensure_map();
             size_type vacancies = start.cur - start.first;
             if (n > vacancies)
             new_elements_at_front(n - vacancies);
@@ -706,6 +1301,7 @@ namespace ltx
         
         iterator reserve_elements_at_back(size_type n)
         {
+            ensure_map();
             size_type vacancies = (finish.last - finish.cur) - 1;
             if (n > vacancies)
             new_elements_at_back(n - vacancies);
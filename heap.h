@@ -23,7 +23,7 @@ namespace ltx
     inline void __push_heap_aux(RandomAccessIterator first, 
     RandomAccessIterator last, Distance*, T*)
     {
-        __push_heap(first, Distance((last-first)-1), Distance(0), T(*(last-1)));
+        ltx::__push_heap(first, Distance((last-first)-1), Distance(0), T(*(last-1)));
     }
 
     // 此函数被调用时, 新元素应已置于容器最尾端
@@ -31,7 +31,7 @@ namespace ltx
     inline void push_heap(RandomAccessIterator first,
                             RandomAccessIterator last)
     {
-        __push_heap_aux(first, last, distance_type(first), value_type(first));
+        ltx::__push_heap_aux(first, last, distance_type(first), value_type(first));
     }
 
 
@@ -55,7 +55,7 @@ namespace ltx
             *(first + holeIndex) = *(first + (secondChild-1));
             holeIndex = secondChild-1;
         }
-        __push_heap(first, holeIndex, topIndex, value);
+        ltx::__push_heap(first, holeIndex, topIndex, value);
     }
 
     // 将[first, last)堆最大元素变为value, 并将原来的堆顶元素放入result中
@@ -68,13 +68,13 @@ namespace ltx
     Distance *)
     {
         *result = *first; // 设定尾值为首值
-        __adjust_heap(first, Distance(0), Distance(last-first), value);
+        ltx::__adjust_heap(first, Distance(0), Distance(last-first), value);
     }
 
     template <typename RandomAccessIterator, typename T>
     inline void __pop_heap_aux(RandomAccessIterator first, RandomAccessIterator last, T*)
     {
-        __pop_heap(first, last-1, last-1, T(*(last-1)), distance_type(first));
+        ltx::__pop_heap(first, last-1, last-1, T(*(last-1)), distance_type(first));
     }
 
 
@@ -82,7 +82,7 @@ namespace ltx
     template <typename RandomAccessIterator>
     inline void pop_heap(RandomAccessIterator first, RandomAccessIterator last)
     {
-        __pop_heap_aux(first, last, value_type(first));
+        ltx::__pop_heap_aux(first, last, value_type(first));
     }
 
 
@@ -92,7 +92,7 @@ namespace ltx
     RandomAccessIterator last)
     {
         while(last-first > 1)
-            pop_heap(first, last--);
+            ltx::pop_heap(first, last--);
     }
 
     template <typename RandomAccessIterator, typename T, typename Distance>
@@ -105,7 +105,7 @@ namespace ltx
         Distance holeIndex = (len-2)/2; // 最后一个节点的父亲, 也就是第一个需要调整的节点
         while (true)
         {
-            __adjust_heap(first, holeIndex, len, T(*(first+holeIndex)));
+            ltx::__adjust_heap(first, holeIndex, len, T(*(first+holeIndex)));
             if(holeIndex == 0) return ;
             holeIndex--;    
         }
@@ -115,7 +115,7 @@ namespace ltx
     inline void make_heap(RandomAccessIterator first, 
     RandomAccessIterator last)
     {
-        __make_heap(first, last, value_type(first), distance_type(first));
+        ltx::__make_heap(first, last, value_type(first), distance_type(first));
     }
 
 
@@ -146,7 +146,7 @@ namespace ltx
                     RandomAccessIterator last, Compare comp,
                     Distance*, T*) 
     {
-        __push_heap(first, Distance((last - first) - 1), Distance(0), 
+        ltx::__push_heap(first, Distance((last - first) - 1), Distance(0), 
                 T(*(last - 1)), comp);
     }
 
@@ -155,7 +155,7 @@ namespace ltx
     push_heap(RandomAccessIterator first, RandomAccessIterator last,
             Compare comp)
     {
-        __push_heap_aux(first, last, comp,
+        ltx::__push_heap_aux(first, last, comp,
                         distance_type(first), value_type(first));
     }
 
@@ -181,7 +181,7 @@ namespace ltx
             *(first + holeIndex) = *(first + (secondChild - 1));
             holeIndex = secondChild - 1;
         }
-        __push_heap(first, holeIndex, topIndex, value, comp);
+        ltx::__push_heap(first, holeIndex, topIndex, value, comp);
     }
 
     template <typename RandomAccessIterator, typename T, typename Compare, 
@@ -192,7 +192,7 @@ namespace ltx
             Distance*)
     {
         *result = *first;
-        __adjust_heap(first, Distance(0), Distance(last - first), 
+        ltx::__adjust_heap(first, Distance(0), Distance(last - first), 
                         value, comp);
     }
 
@@ -201,7 +201,7 @@ namespace ltx
     __pop_heap_aux(RandomAccessIterator first,
                 RandomAccessIterator last, T*, Compare comp)
     {
-        __pop_heap(first, last - 1, last - 1, T(*(last - 1)), comp,
+        ltx::__pop_heap(first, last - 1, last - 1, T(*(last - 1)), comp,
                     distance_type(first));
     }
 
@@ -210,7 +210,7 @@ namespace ltx
     pop_heap(RandomAccessIterator first,
             RandomAccessIterator last, Compare comp)
     {
-        __pop_heap_aux(first, last, value_type(first), comp);
+        ltx::__pop_heap_aux(first, last, value_type(first), comp);
     }
 
 
@@ -227,7 +227,7 @@ namespace ltx
             
         while (true) 
         {
-            __adjust_heap(first, parent, len, T(*(first + parent)),
+            ltx::__adjust_heap(first, parent, len, T(*(first + parent)),
                         comp);
             if (parent == 0) return;
             parent--;
@@ -239,7 +239,7 @@ namespace ltx
     make_heap(RandomAccessIterator first, 
             RandomAccessIterator last, Compare comp)
     {
-        __make_heap(first, last, comp,
+        ltx::__make_heap(first, last, comp,
                 value_type(first), distance_type(first));
     }
 
@@ -250,7 +250,7 @@ namespace ltx
             RandomAccessIterator last, Compare comp)
     {
         while (last - first > 1)
-            pop_heap(first, last--, comp);
+            ltx::pop_heap(first, last--, comp);
     }
 
 
@@ -6,12 +6,16 @@
 
 namespace ltx
 {
-    template <typename T>
-    struct __list_node
+    struct __list_node_base
     {
         typedef void * void_pointer;
         void_pointer prev;
         void_pointer next;
+    };
+
+    template <typename T>
+    struct __list_node : public __list_node_base
+    {
         T data;
     };
 
@@ -71,7 +75,7 @@ namespace ltx
     };
     
     template <typename T, typename Alloc = alloc>
-    class list
+    class list : protected alloc_holder<Alloc>
     {
     protected:
         typedef __list_node<T>      list_node;
@@ -91,15 +95,19 @@ namespace ltx
 
     protected:
         typedef simple_alloc<list_node, Alloc> list_node_allocator;
+        typedef alloc_holder<Alloc> alloc_base;
+        using alloc_base::get_alloc;
 
     protected:
+        // 哨兵节点放在对象内部, node指向它; 构造, 移动和交换都不需要配置节点, 不会抛出异常
+        __list_node_base head;
         link_type node;
 
     protected:
         // 配置一个节点
-        link_type get_node() { return list_node_allocator::allocate(); }
+        link_type get_node() { return list_node_allocator::allocate(get_alloc()); }
         // 释放一个节点
-        void put_node(link_type p) { list_node_allocator::deallocate(p); }
+        void put_node(link_type p) { list_node_allocator::deallocate(get_alloc(), p); }
 
         // 配置并构造一个节点
         link_type create_node(const T&x)
@@ -120,7 +128,7 @@ namespace ltx
         // 空链表初始化
         void empty_initialize()
         {
-            node = get_node();
+            node = static_cast<link_type>(&head);
             node->next = node;
             node->prev = node;
         }
@@ -128,19 +136,70 @@ namespace ltx
 
     public:
         list() { empty_initialize(); }
+        explicit list(const Alloc& a) :alloc_base(a) { empty_initialize(); }
+
+        // 复制和移动都会连同配置器一起传播
+        list(const list<T, Alloc>& x) :alloc_base(x.get_alloc())
+        {
+            empty_initialize();
+            insert(end(), x.begin(), x.end());
+        }
+
+        // 接管x的节点, x成为空链表
+        list(list<T, Alloc>&& x) noexcept :alloc_base(x.get_alloc())
+        {
+            empty_initialize();
+            swap_nodes(x);
+        }
+
+        ~list()
+        {
+            clear();
+        }
+
+        list<T, Alloc>& operator=(const list<T, Alloc>& x)
+        {
+            if(this == &x) return *this;
+            if(!this->same_alloc(x))
+            {
+                // 配置器不同, 先用原配置器释放所有节点
+                clear();
+                get_alloc() = x.get_alloc();
+            }
+            iterator first1 = begin();
+            iterator last1 = end();
+            iterator first2 = x.begin();
+            iterator last2 = x.end();
+            while(first1 != last1 && first2 != last2)
+                *first1++ = *first2++;
+            if(first2 == last2) erase(first1, last1);
+            else insert(last1, first2, last2);
+            return *this;
+        }
+
+        list<T, Alloc>& operator=(list<T, Alloc>&& x) noexcept
+        {
+            if(this == &x) return *this;
+            clear();
+            get_alloc() = x.get_alloc();
+            swap_nodes(x);
+            return *this;
+        }
+
+        Alloc get_allocator() const { return get_alloc(); }
 
 
     public:
         iterator begin() { return (link_type)((*node).next); }
         iterator end() { return node; }
+        iterator begin() const { return (link_type)((*node).next); }
+        iterator end() const { return node; }
 
         bool empty() const { return node->next == node; }
 
         size_type size() const 
         {
-            size_type result = 0;
-            distance(begin(), end(), result);
-            return result;
+            return size_type(ltx::distance(begin(), end()));
         }
         
         // 返回第一个元素值的引用
@@ -160,6 +219,13 @@ namespace ltx
             return tmp;
         }
 
+        template <typename InputIterator>
+        void insert(iterator position, InputIterator first, InputIterator last)
+        {
+            for(; first != last; ++first)
+                insert(position, *first);
+        }
+
         void push_front(const T&x)
         {
             insert(begin(), x); 
@@ -176,10 +242,16 @@ namespace ltx
             link_type prev_node = link_type(position.node->prev);
             prev_node->next = next_node;
             next_node->prev = prev_node;
-            _destroy(position.node);
+            destroy_node(position.node);
             return iterator(next_node);
         }
 
+        iterator erase(iterator first, iterator last)
+        {
+            while(first != last) erase(first++);
+            return last;
+        }
+
         void pop_front() { erase(begin()); }
         void pop_back()
         {
@@ -195,7 +267,7 @@ namespace ltx
             {
                 link_type tmp = cur;
                 cur = (link_type) cur->next;
-                _destroy(tmp);
+                destroy_node(tmp);
             }
             node->prev = node;
             node->next = node;
@@ -290,12 +362,11 @@ namespace ltx
             }
         }
 
-        // 交换两个链表
-        void swap(list<T, Alloc>& x)
+        // 交换两个链表, 配置器一起交换
+        void swap(list<T, Alloc>& x) noexcept
         {
-            link_type tmp = node;
-            node = x.node;
-            x.node = tmp;
+            swap_nodes(x);
+            this->swap_alloc(x);
         }
 
         // 合并两个有序递增的链表
@@ -341,6 +412,7 @@ namespace ltx
         {
             if(node->next == node || link_type(node->next)->next==node) return ;
 
+            // 中间链表只用来暂存本链表的节点, 节点始终由本链表的配置器释放
             list<T, Alloc> carry; // 中间变量
             list<T, Alloc> counter[64]; 
             // counter[i]容量为2^(i+1)个元素, 达到2^(i+1)个元素后
@@ -361,13 +433,13 @@ namespace ltx
                 while(i<fill && !counter[i].empty())
                 {
                     counter[i].merge(carry);
-                    carry.swap(counter[i++]);
+                    carry.swap_nodes(counter[i++]);
                     // counter[i]不为空(由循环进入条件保证)
                     // 又merge了一个carry, 所以需要向counter[i+1]merge
                     // 如果counter[i+1]为空, 将由循环后面的语句将carry放到counter[i+1]处
                     // 否则接着在循环中不断向上merge
                 }
-                carry.swap(counter[i]);
+                carry.swap_nodes(counter[i]);
                 if(i == fill) ++fill;
             }
             // 外层循环最多循环n次, 内层最多循环log(n)次
@@ -376,7 +448,17 @@ namespace ltx
 
             for (int i=1; i<fill; ++i)
                 counter[i].merge(counter[i-1]);
-            swap(counter[fill-1]);
+            splice(end(), counter[fill-1]);
+        }
+
+    protected:
+        // 只交换元素, 不交换配置器
+        void swap_nodes(list<T, Alloc>& x)
+        {
+            if(this == &x) return ;
+            iterator old_first = begin();
+            splice(old_first, x);
+            x.splice(x.end(), *this, old_first, end());
         }
 
     };
@@ -0,0 +1,303 @@
+#ifndef MAPPED_VECTOR_H
+#define MAPPED_VECTOR_H
+
+#include "vector.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ltx
+{
+    // mapped_vector的文件头, 位于文件开头, 元素紧随其后
+    // 元素个数保存在映射的文件头中, 重新打开时不需要任何反序列化
+    struct mapped_header
+    {
+        std::uint64_t magic;
+        std::uint64_t size;         // 元素个数
+        std::uint64_t elem_size;    // sizeof(T), 打开时用来检查类型
+        std::uint64_t pad[5];
+    };
+
+    // 以内存映射文件为存储的vector
+    // 文件以MAP_SHARED映射, 多个进程打开同一个文件时共享页缓存
+    // 增长时先用ftruncate扩展文件, 再用mremap扩展映射(非Linux平台重新映射)
+    // 元素必须可以逐字节复制, 且不能含有指针这类和进程相关的值
+    // 只读打开时不能修改, 文件不能在其他进程中被截短
+    template <typename T, typename Grow = grow_double>
+    class mapped_vector
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "mapped_vector requires trivially copyable elements");
+        static_assert(alignof(T) <= sizeof(mapped_header), "element alignment exceeds the file header");
+
+    public:
+        typedef T                   value_type;
+        typedef value_type*         pointer;
+        typedef const value_type*   const_pointer;
+        typedef value_type*         iterator;
+        typedef const value_type*   const_iterator;
+        typedef value_type&         reference;
+        typedef const value_type&   const_reference;
+        typedef size_t              size_type;
+        typedef ptrdiff_t           difference_type;
+
+    private:
+        static const std::uint64_t magic = 0x3130565854ULL;     // "TXV01"
+
+        int fd;
+        mapped_header * header;
+        size_t length;              // 映射的字节数, 和文件长度相同
+        bool read_only;
+
+        static size_t page_size()
+        {
+            static const size_t sz = (size_t) sysconf(_SC_PAGESIZE);
+            return sz;
+        }
+        // 容纳n个元素的文件长度, 上调至页大小的倍数
+        static size_t file_length(size_type n)
+        {
+            size_t bytes = sizeof(mapped_header) + n*sizeof(T);
+            return (bytes + page_size() - 1) & ~(page_size() - 1);
+        }
+
+        T * data_start() const { return (T*)((char*)header + sizeof(mapped_header)); }
+
+    public:
+        mapped_vector() : fd(-1), header(nullptr), length(0), read_only(false) {}
+
+        explicit mapped_vector(const char * path, bool ro = false)
+            : fd(-1), header(nullptr), length(0), read_only(false)
+        {
+            if(!open(path, ro)) throw std::runtime_error("mapped_vector: cannot map file");
+        }
+
+        mapped_vector(mapped_vector&& x) : fd(x.fd), header(x.header), length(x.length), read_only(x.read_only)
+        {
+            x.fd = -1;
+            x.header = nullptr;
+            x.length = 0;
+        }
+
+        mapped_vector& operator=(mapped_vector&& x)
+        {
+            if(&x == this) return *this;
+            close();
+            swap(x);
+            return *this;
+        }
+
+        mapped_vector(const mapped_vector&) = delete;
+        mapped_vector& operator=(const mapped_vector&) = delete;
+
+        ~mapped_vector() { close(); }
+
+        // 打开path, 文件不存在或为空时创建新的数组(只读打开时失败)
+        // 文件头不匹配时失败, 之前打开的文件被关闭
+        bool open(const char * path, bool ro = false)
+        {
+            close();
+            fd = ::open(path, ro ? O_RDONLY : O_RDWR|O_CREAT, 0644);
+            if(fd < 0) return false;
+            struct stat st;
+            if(fstat(fd, &st) != 0) return fail();
+            size_t len = (size_t) st.st_size;
+            const bool fresh = len == 0;
+            if(fresh)
+            {
+                if(ro) return fail();
+                len = file_length(0);
+                if(ftruncate(fd, (off_t)len) != 0) return fail();
+            }
+            else if(len < sizeof(mapped_header)) return fail();
+
+            void * p = mmap(0, len, ro ? PROT_READ : PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+            if(p == MAP_FAILED) return fail();
+            header = (mapped_header*) p;
+            length = len;
+            read_only = ro;
+            if(fresh)
+            {
+                header->magic = magic;
+                header->size = 0;
+                header->elem_size = sizeof(T);
+            }
+            else if(header->magic != magic || header->elem_size != sizeof(T) || header->size > capacity())
+            {
+                munmap(header, length);
+                header = nullptr;
+                length = 0;
+                return fail();
+            }
+            return true;
+        }
+
+        // 解除映射并关闭文件, 已修改的页由内核写回
+        void close()
+        {
+            if(header != nullptr) munmap(header, length);
+            if(fd >= 0) ::close(fd);
+            fd = -1;
+            header = nullptr;
+            length = 0;
+        }
+
+        // 把修改写回文件, async为true时只安排写回, 不等待完成
+        bool flush(bool async = false)
+        {
+            if(header == nullptr || read_only) return true;
+            return msync(header, length, async ? MS_ASYNC : MS_SYNC) == 0;
+        }
+
+        bool is_open() const { return header != nullptr; }
+
+        iterator begin() { return data(); }
+        iterator end() { return data() + size(); }
+        const_iterator begin() const { return data(); }
+        const_iterator end() const { return data() + size(); }
+
+        pointer data() { return header != nullptr ? data_start() : nullptr; }
+        const_pointer data() const { return header != nullptr ? data_start() : nullptr; }
+
+        size_type size() const { return header != nullptr ? size_type(header->size) : 0; }
+        size_type capacity() const
+        {
+            return header != nullptr ? (length - sizeof(mapped_header)) / sizeof(T) : 0;
+        }
+        bool empty() const { return size() == 0; }
+
+        reference operator[](size_type n) { return data()[n]; }
+        const_reference operator[](size_type n) const { return data()[n]; }
+        reference front() { return *begin(); }
+        reference back() { return *(end() - 1); }
+        const_reference front() const { return *begin(); }
+        const_reference back() const { return *(end() - 1); }
+
+        void reserve(size_type n)
+        {
+            check_open();
+            if(n > capacity()) remap(file_length(n));
+        }
+
+        // 以下修改操作在只读打开时抛出runtime_error, 映射是PROT_READ的, 写入会导致段错误
+        // 没有打开文件时, 需要改动文件的操作(push_back, pop_back, resize等)也抛出runtime_error
+        // x可能位于映射之中, 增长前先复制出来
+        void push_back(const T& x)
+        {
+            check_writable();
+            if(size() == capacity())
+            {
+                T tmp = x;
+                grow_for(1);
+                data_start()[header->size++] = tmp;
+                return ;
+            }
+            data_start()[header->size++] = x;
+        }
+        void pop_back()
+        {
+            check_writable();
+            check_open();
+            --header->size;
+        }
+
+        template <typename InputIterator>
+        void append(InputIterator first, InputIterator last)
+        {
+            check_writable();
+            for(; first != last; ++first) push_back(*first);
+        }
+
+        void resize(size_type new_size, const T& x = T())
+        {
+            check_writable();
+            check_open();
+            if(new_size > size())
+            {
+                T tmp = x;
+                grow_for(new_size - size());
+                std::fill(end(), data_start() + new_size, tmp);
+            }
+            header->size = new_size;
+        }
+        void clear()
+        {
+            check_writable();
+            if(header != nullptr) header->size = 0;
+        }
+
+        // 把文件截短到刚好容纳现有元素的页数
+        void shrink_to_fit()
+        {
+            check_writable();
+            if(header != nullptr && file_length(size()) < length) remap(file_length(size()));
+        }
+
+        void swap(mapped_vector& x)
+        {
+            std::swap(fd, x.fd);
+            std::swap(header, x.header);
+            std::swap(length, x.length);
+            std::swap(read_only, x.read_only);
+        }
+
+    private:
+        void check_writable() const
+        {
+            if(read_only) throw std::runtime_error("mapped_vector: file is read-only");
+        }
+
+        void check_open() const
+        {
+            if(header == nullptr) throw std::runtime_error("mapped_vector: no file is open");
+        }
+
+        bool fail()
+        {
+            if(fd >= 0) ::close(fd);
+            fd = -1;
+            return false;
+        }
+
+        // 保证还能再放n个元素, 新容量由增长策略决定
+        void grow_for(size_type n)
+        {
+            check_open();
+            if(capacity() - size() < n)
+                remap(file_length(Grow::next_capacity(capacity(), size() + n, sizeof(T))));
+        }
+
+        // 把文件和映射调整为new_len字节
+        // 扩展时先扩展文件再扩展映射, 缩小时反过来, 映射中始终没有超出文件末尾的页
+        void remap(size_t new_len)
+        {
+            check_writable();
+            if(new_len > length && ftruncate(fd, (off_t)new_len) != 0) throw std::bad_alloc();
+#if defined(__linux__)
+            void * p = mremap(header, length, new_len, MREMAP_MAYMOVE);
+#else
+            munmap(header, length);
+            void * p = mmap(0, new_len, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+#endif
+            if(p == MAP_FAILED) throw std::bad_alloc();
+            if(new_len < length)
+            {
+                // 映射已经缩小, 截短失败时文件保留原来的长度, 不影响正确性
+                int rc = ftruncate(fd, (off_t)new_len);
+                (void) rc;
+            }
+            header = (mapped_header*) p;
+            length = new_len;
+        }
+    };
+
+}
+
+#endif
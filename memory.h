@@ -5,6 +5,7 @@
 #include "stl_alloc.h"
 #include "stl_iterator.h"
 #include "stl_uninitialized.h"
+#include <type_traits>
 
 
 namespace ltx
@@ -35,7 +36,7 @@ namespace ltx
 
         void deallocate(pointer p, size_type n)
         {
-            default_alloc::deallocate(p, n);
+            default_alloc::deallocate(p, (size_t)n*sizeof(value_type));
         }
 
         void construct(pointer p, const T& value) 
@@ -84,6 +85,79 @@ namespace ltx
         {
             Alloc::deallocate(p, sizeof(T));
         }
+
+        // 以下版本通过配置器实例配置, 供保存了配置器的容器使用
+        // 对default_alloc这类只有静态函数的配置器, 结果与上面的版本相同
+        static T * allocate(Alloc & a, size_t n)
+        {
+            return 0==n ? nullptr : (T*)a.allocate(n*sizeof(T));
+        }
+        static T * allocate(Alloc & a)
+        {
+            return (T*) a.allocate(sizeof(T));
+        }
+        static void deallocate(Alloc & a, T *p, size_t n)
+        {
+            if(0!=n) a.deallocate(p, n*sizeof(T));
+        }
+        static void deallocate(Alloc & a, T *p)
+        {
+            a.deallocate(p, sizeof(T));
+        }
+
+        // 把p处n个元素的空间调整为new_n个元素, 按字节保留原有内容, 返回新地址
+        // 只能用于可平凡搬迁的元素, 且配置器须提供reallocate(见has_reallocate)
+        static T * reallocate(Alloc & a, T *p, size_t n, size_t new_n)
+        {
+            return (T*) a.reallocate(p, n*sizeof(T), new_n*sizeof(T));
+        }
+    };
+
+    // 配置器是否提供reallocate(void* p, size_t old_sz, size_t new_sz)
+    // 提供时容器可以原地扩展空间(例如mmap_alloc用mremap), 避免复制和新旧空间同时存在
+    template <typename Alloc>
+    class has_reallocate
+    {
+    private:
+        template <typename A>
+        static auto test(int) 
+            -> decltype(std::declval<A&>().reallocate((void*)0, size_t(0), size_t(0)), std::true_type());
+        template <typename A>
+        static std::false_type test(...);
+
+    public:
+        enum {value = decltype(test<Alloc>(0))::value};
+    };
+
+    // 容器通过继承alloc_holder保存配置器实例
+    // default_alloc这类无状态配置器是空类, 空基类优化使它不占用容器的空间
+    template <typename Alloc>
+    class alloc_holder : private Alloc
+    {
+    public:
+        alloc_holder() : Alloc() {}
+        explicit alloc_holder(const Alloc& a) : Alloc(a) {}
+
+        Alloc& get_alloc() { return *this; }
+        const Alloc& get_alloc() const { return *this; }
+
+        // 两个配置器能否互相释放对方配置的空间
+        // 无状态配置器总是可以, 有状态配置器需要提供operator==
+        bool same_alloc(const alloc_holder& x) const
+        {
+            return __alloc_equal(get_alloc(), x.get_alloc(), std::is_empty<Alloc>());
+        }
+
+        void swap_alloc(alloc_holder& x)
+        {
+            Alloc tmp = get_alloc();
+            get_alloc() = x.get_alloc();
+            x.get_alloc() = tmp;
+        }
+
+    private:
+        static bool __alloc_equal(const Alloc&, const Alloc&, std::true_type) { return true; }
+        static bool __alloc_equal(const Alloc& a, const Alloc& b, std::false_type) { return a == b; }
     };
 }
 
@@ -58,7 +58,7 @@ namespace ltx
         typedef typename rep_type::difference_type difference_type;
 
         multimap() :t(Compare()) {}
-        explicit multimap(const Compare& comp) :t(comp) {}
+        explicit multimap(const Compare& comp, const Alloc& a = Alloc()) :t(comp, a) {}
 
         template <typename InputIterator>
         multimap(InputIterator first, InputIterator last) 
@@ -74,12 +74,22 @@ namespace ltx
             t.insert_equal(first, last);
         }
 
-        multimap(const multimap<Key, T, Compare, Alloc>& x) :t(x) {}
-        multimap<Key, T, Compare, Alloc>& operator==(const multimap<Key, T, Compare, Alloc>& x)
+        multimap(const multimap<Key, T, Compare, Alloc>& x) :t(x.t) {}
+        multimap(multimap<Key, T, Compare, Alloc>&& x) noexcept(std::is_nothrow_move_constructible<rep_type>::value)
+            :t(std::move(x.t)) {}
+        multimap<Key, T, Compare, Alloc>& operator=(const multimap<Key, T, Compare, Alloc>& x)
         {
             t = x.t;
             return *this;
         }
+        multimap<Key, T, Compare, Alloc>& operator=(multimap<Key, T, Compare, Alloc>&& x)
+            noexcept(std::is_nothrow_move_assignable<rep_type>::value)
+        {
+            t = std::move(x.t);
+            return *this;
+        }
+        void swap(multimap<Key, T, Compare, Alloc>& x) { t.swap(x.t); }
+        Alloc get_allocator() const { return t.get_allocator(); }
 
         key_compare key_comp() const { return t.key_comp(); }
         value_compare value_comp() const { return value_compare(t.key_comp()); }
@@ -92,7 +102,6 @@ namespace ltx
         bool empty() const { return t.empty(); }
         size_type size() const { return t.size(); }
         size_type max_size() const { return t.max_size(); }
-        // void swap(set<Key, Compare, Alloc>& x) { t.swap(x.t); }
 
         iterator insert(const value_type& x)
         {
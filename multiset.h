@@ -36,7 +36,7 @@ namespace ltx
         typedef typename rep_type::difference_type difference_type;
 
         multiset() : t(Compare()) {}
-        explicit multiset(const Compare& comp) : t(comp) {}
+        explicit multiset(const Compare& comp, const Alloc& a = Alloc()) : t(comp, a) {}
 
         template <typename InputIterator>
         multiset(InputIterator first, InputIterator last) : t(Compare())
@@ -51,13 +51,23 @@ namespace ltx
             t.insert_equal(first, last);
         }
 
-        multiset(const multiset<Key, Compare, Alloc> &x) :t(x.t) {}
+        multiset(const multiset<Key, Compare, Alloc>& x) :t(x.t) {}
+        multiset(multiset<Key, Compare, Alloc>&& x) noexcept(std::is_nothrow_move_constructible<rep_type>::value)
+            :t(std::move(x.t)) {}
 
-        multiset<Key, Compare, Alloc>& operator= (const multiset<Key, Compare, Alloc>& x)
+        multiset<Key, Compare, Alloc>& operator=(const multiset<Key, Compare, Alloc>& x)
         {
             t = x.t;
             return *this;
         }
+        multiset<Key, Compare, Alloc>& operator=(multiset<Key, Compare, Alloc>&& x)
+            noexcept(std::is_nothrow_move_assignable<rep_type>::value)
+        {
+            t = std::move(x.t);
+            return *this;
+        }
+        void swap(multiset<Key, Compare, Alloc>& x) { t.swap(x.t); }
+        Alloc get_allocator() const { return t.get_allocator(); }
 
 
         // 以下所有方法都只是调用rb_tree中相应方法
@@ -68,7 +78,6 @@ namespace ltx
         bool empty() const { return t.empty(); }
         size_type size() const { return t.size(); }
         size_type max_size() const { return t.max_size(); }
-        // void swap(multiset<Key, Compare, Alloc>& x) { t.swap(x.t); }
 
         iterator insert(const value_type& x)
         {
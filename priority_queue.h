@@ -31,7 +31,7 @@ namespace ltx
             try
             {
                 c.push_back(x);
-                push_heap(c.begin(), c.end(), comp);
+                ltx::push_heap(c.begin(), c.end(), comp);
             }
             catch(...)
             {
@@ -43,7 +43,7 @@ namespace ltx
         {
             try
             {
-                pop_heap(c.begin(), c.end(), comp);
+                ltx::pop_heap(c.begin(), c.end(), comp);
                 c.pop_back();
             }
             catch(...)
@@ -2,9 +2,11 @@
 #define QUEUE_H
 
 #include "deque.h"
+#include <utility>
 
 namespace ltx
 {
+    // Sequence可以是deque, list或ring_buffer
     template <typename T, typename Sequence = deque<T>>
     class queue
     {
@@ -16,6 +18,10 @@ namespace ltx
     protected:
         Sequence c;
     public:
+        queue() : c() {}
+        explicit queue(const Sequence& s) : c(s) {}
+        explicit queue(Sequence&& s) : c(std::move(s)) {}
+
         bool empty() { return c.empty(); }
         size_type size() const { return c.size(); }
         reference front() { return c.front(); }
@@ -23,6 +29,7 @@ namespace ltx
         reference back() { return c.back(); }
         const_reference back() const { return c.back(); }
         void push(const value_type& x) { c.push_back(x); }
+        void push(value_type&& x) { c.push_back(std::move(x)); }
         void pop() { c.pop_front(); }
     };
 
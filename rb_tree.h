@@ -153,7 +153,7 @@ namespace ltx
 
     template <typename Key, typename Value, typename KeyOfValue, typename Compare, 
     typename Alloc = alloc>
-    class rb_tree
+    class rb_tree : protected alloc_holder<Alloc>
     {
     protected:
         typedef void* void_pointer;
@@ -161,6 +161,8 @@ namespace ltx
         typedef __rb_tree_node<Value> rb_tree_node;
 
         typedef simple_alloc<rb_tree_node, Alloc> rb_tree_node_allocator;
+        typedef alloc_holder<Alloc> alloc_base;
+        using alloc_base::get_alloc;
 
         typedef __rb_tree_color_type color_type;
     
@@ -178,11 +180,11 @@ namespace ltx
     protected:
         link_type get_node()
         {
-            return rb_tree_node_allocator::allocate();
+            return rb_tree_node_allocator::allocate(get_alloc());
         }
         void put_node(link_type p)
         {
-            rb_tree_node_allocator::deallocate(p);
+            rb_tree_node_allocator::deallocate(get_alloc(), p);
         }
 
         link_type create_node(const value_type & x)
@@ -195,6 +197,7 @@ namespace ltx
             catch(...)
             {
                 put_node(tmp);
+                throw;
             }
             return tmp;
         }
@@ -214,10 +217,15 @@ namespace ltx
             put_node(p);
         }
 
+        // header节点放在对象内部, header指向它; 构造, 移动和交换都不需要配置节点
+        __rb_tree_node_base header_node;
         size_type node_count;
         link_type header;
         Compare key_compare;
 
+        enum { __NOTHROW_MOVE = std::is_nothrow_copy_constructible<Compare>::value
+            && std::is_nothrow_copy_assignable<Compare>::value };
+
         link_type& root() const { return (link_type&) header->parent; }
         link_type& leftmost() const { return (link_type&) header->left; }
         link_type& rightmost() const { return (link_type&) header->right; }
@@ -323,7 +331,34 @@ namespace ltx
             return iterator(z);
         }
 
-        link_type __copy(link_type x, link_type p);
+        // 复制以x为根的子树, 新子树的父节点为p
+        link_type __copy(link_type x, link_type p)
+        {
+            link_type top = clone_type(x);
+            top->parent = p;
+            try
+            {
+                // 右子树递归复制, 左子树沿左链迭代复制
+                if(x->right != nullptr) top->right = __copy(right(x), top);
+                p = top;
+                x = left(x);
+                while(x != nullptr)
+                {
+                    link_type y = clone_type(x);
+                    p->left = y;
+                    y->parent = p;
+                    if(x->right != nullptr) y->right = __copy(right(x), y);
+                    p = y;
+                    x = left(x);
+                }
+            }
+            catch(...)
+            {
+                __earse(top);
+                throw;
+            }
+            return top;
+        }
 
         // 删除而不重新平衡
         void __earse(link_type x)
@@ -340,7 +375,7 @@ namespace ltx
 
         void init()
         {
-            header = get_node();
+            header = static_cast<link_type>(&header_node);
             color(header) = __rb_tree_red;
             root() = 0;
             leftmost() = header;
@@ -348,14 +383,34 @@ namespace ltx
         }
 
     public:
-        rb_tree(const Compare& comp = Compare())
-            :node_count(0), key_compare(comp) { init(); }
+        rb_tree(const Compare& comp = Compare(), const Alloc& a = Alloc())
+            :alloc_base(a), node_count(0), key_compare(comp) { init(); }
+
+        // 复制和移动都会连同配置器一起传播
+        rb_tree(const rb_tree<Key,Value, KeyOfValue, Compare, Alloc>& x)
+            :alloc_base(x.get_alloc()), node_count(0), key_compare(x.key_compare)
+        {
+            init();
+            if(x.root() != nullptr)
+            {
+                root() = __copy(x.root(), header);
+                leftmost() = minimum(root());
+                rightmost() = maximum(root());
+                node_count = x.node_count;
+            }
+        }
+
+        // 接管x的节点, x成为空树
+        rb_tree(rb_tree<Key,Value, KeyOfValue, Compare, Alloc>&& x) noexcept(__NOTHROW_MOVE)
+            :alloc_base(x.get_alloc()), node_count(0), key_compare(x.key_compare)
+        {
+            init();
+            swap_tree(x);
+        }
         
-        // clear 定义
         ~rb_tree()
         {
-            // clear();
-            put_node(header);
+            clear();
         }
 
         void clear()
@@ -365,7 +420,7 @@ namespace ltx
                 __earse(root());
                 leftmost() = header;
                 root() = nullptr;
-                rightmost = header;
+                rightmost() = header;
                 node_count = 0;
             }
         }
@@ -376,6 +431,11 @@ namespace ltx
             if (this != &x) {
                                             // Note that Key may be a constant type.
                 clear();
+                if (!this->same_alloc(x))
+                {
+                    // 节点已用原配置器释放, 换成x的配置器
+                    get_alloc() = x.get_alloc();
+                }
                 node_count = 0;
                 key_compare = x.key_compare;        
                 if (x.root() == nullptr) 
@@ -386,7 +446,7 @@ namespace ltx
                 }
                 else 
                 {
-                    root() = copy(x.root(), header);
+                    root() = __copy(x.root(), header);
                     leftmost() = minimum(root());
                     rightmost() = maximum(root());
                     node_count = x.node_count;
@@ -395,12 +455,50 @@ namespace ltx
             return *this;
         }
 
-        // void swap(_Rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& t) 
-        // {
-        //     swap(header, t.header);
-        //     swap(node_count, t.node_count);
-        //     swap(key_compare, t.key_compare);
-        // }
+        rb_tree<Key,Value, KeyOfValue, Compare, Alloc>& 
+        operator=(rb_tree<Key,Value, KeyOfValue, Compare, Alloc>&& x) noexcept(__NOTHROW_MOVE)
+        {
+            if (this != &x)
+            {
+                clear();
+                get_alloc() = x.get_alloc();
+                key_compare = x.key_compare;
+                swap_tree(x);
+            }
+            return *this;
+        }
+
+        void swap(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& t) noexcept(__NOTHROW_MOVE)
+        {
+            swap_tree(t);
+            std::swap(key_compare, t.key_compare);
+            this->swap_alloc(t);
+        }
+
+        Alloc get_allocator() const { return get_alloc(); }
+
+    protected:
+        // 只交换树中的节点, 不交换比较函数和配置器
+        // header在对象内部不能直接交换, 交换根和两端后再把根的parent指回各自的header
+        void swap_tree(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& t)
+        {
+            std::swap(root(), t.root());
+            std::swap(leftmost(), t.leftmost());
+            std::swap(rightmost(), t.rightmost());
+            std::swap(node_count, t.node_count);
+            fix_header();
+            t.fix_header();
+        }
+
+        void fix_header()
+        {
+            if(root() == nullptr)
+            {
+                leftmost() = header;
+                rightmost() = header;
+            }
+            else parent(root()) = header;
+        }
         
 
     public:
@@ -0,0 +1,313 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "memory.h"
+#include "stl_iterator.h"
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+namespace ltx
+{
+    // 迭代器保存不取模的位置, 解引用时再和mask相与
+    template <typename T, typename Ref, typename Ptr>
+    struct __ring_iterator
+    {
+        typedef __ring_iterator<T, T&, T*> iterator;
+        typedef __ring_iterator<T, const T&, const T*> const_iterator;
+
+        typedef random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef ptrdiff_t difference_type;
+
+        typedef __ring_iterator self;
+
+        T* buf;
+        size_t mask;
+        size_t pos;
+
+        __ring_iterator(T* x, size_t m, size_t p) : buf(x), mask(m), pos(p) {}
+        __ring_iterator() : buf(0), mask(0), pos(0) {}
+        __ring_iterator(const iterator& x) : buf(x.buf), mask(x.mask), pos(x.pos) {}
+
+        reference operator*() const { return buf[pos & mask]; }
+        pointer operator->() const { return &buf[pos & mask]; }
+        reference operator[](difference_type n) const { return buf[(pos + n) & mask]; }
+
+        self& operator++() { ++pos; return *this; }
+        self operator++(int) { self tmp = *this; ++pos; return tmp; }
+        self& operator--() { --pos; return *this; }
+        self operator--(int) { self tmp = *this; --pos; return tmp; }
+        self& operator+=(difference_type n) { pos += n; return *this; }
+        self& operator-=(difference_type n) { pos -= n; return *this; }
+        self operator+(difference_type n) const { self tmp = *this; return tmp += n; }
+        self operator-(difference_type n) const { self tmp = *this; return tmp -= n; }
+        difference_type operator-(const self& x) const { return difference_type(pos - x.pos); }
+
+        bool operator==(const self& x) const { return pos == x.pos; }
+        bool operator!=(const self& x) const { return pos != x.pos; }
+        bool operator<(const self& x) const { return pos < x.pos; }
+        bool operator>(const self& x) const { return x < *this; }
+        bool operator<=(const self& x) const { return !(x < *this); }
+        bool operator>=(const self& x) const { return !(*this < x); }
+    };
+
+    // 环形缓冲区
+    // 元素放在一块容量为2的幂的连续空间中, 下标和mask相与得到位置, 两端的插入和删除都不需要配置空间
+    // Capacity为0时空间不足就加倍; 否则最多容纳Capacity个元素, 空间在第一次插入时一次配置好
+    // 构造和移动都不配置空间, 移动构造和移动赋值不会抛出异常
+    // Overwrite为true时(需要固定容量), 满了以后再插入会覆盖另一端最旧的元素, 否则抛出length_error
+    // 可以作为queue和stack的Sequence
+    template <typename T, size_t Capacity = 0, bool Overwrite = false, typename Alloc = alloc>
+    class ring_buffer : protected alloc_holder<Alloc>
+    {
+        static_assert(Capacity != 0 || !Overwrite, "overwrite mode needs a fixed capacity");
+
+    public:
+        typedef T                   value_type;
+        typedef value_type*         pointer;
+        typedef value_type&         reference;
+        typedef const value_type&   const_reference;
+        typedef size_t              size_type;
+        typedef ptrdiff_t           difference_type;
+        typedef __ring_iterator<T, T&, T*>              iterator;
+        typedef __ring_iterator<T, const T&, const T*>  const_iterator;
+
+    protected:
+        typedef simple_alloc<value_type, Alloc> data_allocator;
+        typedef alloc_holder<Alloc> alloc_base;
+        using alloc_base::get_alloc;
+
+        enum {__MIN_STORAGE = 8};
+
+        T * buf;
+        size_type mask;         // 空间大小减1
+        size_type head;         // 第一个元素的位置, 在[0, mask]之间
+        size_type count;
+        size_type limit;        // count达到limit时插入要走emplace_full: 没有空间时为0, 否则为容量
+
+        static size_type round_up_pow2(size_type n)
+        {
+            size_type result = 1;
+            while(result < n) result <<= 1;
+            return result;
+        }
+
+        size_type storage() const { return buf != nullptr ? mask + 1 : 0; }
+        T * slot(size_type i) const { return buf + ((head + i) & mask); }
+
+    public:
+        iterator begin() { return iterator(buf, mask, head); }
+        iterator end() { return iterator(buf, mask, head + count); }
+        const_iterator begin() const { return const_iterator(buf, mask, head); }
+        const_iterator end() const { return const_iterator(buf, mask, head + count); }
+
+        size_type size() const { return count; }
+        size_type capacity() const { return Capacity != 0 ? Capacity : storage(); }
+        bool empty() const { return count == 0; }
+        bool full() const { return count == capacity(); }
+
+        reference operator[](size_type n) { return *slot(n); }
+        const_reference operator[](size_type n) const { return *slot(n); }
+        reference front() { return *slot(0); }
+        const_reference front() const { return *slot(0); }
+        reference back() { return *slot(count - 1); }
+        const_reference back() const { return *slot(count - 1); }
+
+        ring_buffer() : buf(nullptr), mask(0), head(0), count(0), limit(0) {}
+        explicit ring_buffer(const Alloc& a) : alloc_base(a), buf(nullptr), mask(0), head(0), count(0), limit(0) {}
+
+        ring_buffer(const ring_buffer& x)
+            : alloc_base(x.get_alloc()), buf(nullptr), mask(0), head(0), count(0), limit(0)
+        {
+            if(x.count != 0) allocate_storage(round_up_pow2(Capacity != 0 ? Capacity : x.count));
+            try
+            {
+                for(; count < x.count; ++count) _construct(buf + count, x[count]);
+            }
+            catch(...)
+            {
+                clear();
+                deallocate_storage();
+                throw;
+            }
+        }
+
+        // x留下没有空间的空缓冲区, 仍然可用, 下次插入时再配置
+        ring_buffer(ring_buffer&& x) noexcept
+            : alloc_base(x.get_alloc()), buf(x.buf), mask(x.mask), head(x.head), count(x.count), limit(x.limit)
+        {
+            x.buf = nullptr;
+            x.mask = x.head = x.count = x.limit = 0;
+        }
+
+        ~ring_buffer()
+        {
+            clear();
+            deallocate_storage();
+        }
+
+        ring_buffer& operator=(const ring_buffer& x)
+        {
+            if(&x == this) return *this;
+            ring_buffer tmp(x);
+            swap(tmp);
+            return *this;
+        }
+
+        ring_buffer& operator=(ring_buffer&& x) noexcept
+        {
+            if(&x == this) return *this;
+            ring_buffer tmp(std::move(x));
+            swap(tmp);
+            return *this;
+        }
+
+        void swap(ring_buffer& x) noexcept
+        {
+            std::swap(buf, x.buf);
+            std::swap(mask, x.mask);
+            std::swap(head, x.head);
+            std::swap(count, x.count);
+            std::swap(limit, x.limit);
+            this->swap_alloc(x);
+        }
+
+        Alloc get_allocator() const { return get_alloc(); }
+
+        // 只对可增长的缓冲区有效
+        void reserve(size_type n)
+        {
+            if(Capacity == 0 && n > storage()) reallocate(round_up_pow2(n));
+        }
+
+        void push_back(const value_type& x) { emplace_back(x); }
+        void push_back(value_type&& x) { emplace_back(std::move(x)); }
+        void push_front(const value_type& x) { emplace_front(x); }
+        void push_front(value_type&& x) { emplace_front(std::move(x)); }
+
+        template <typename... Args>
+        void emplace_back(Args&&... args)
+        {
+            if(count == limit)
+            {
+                emplace_full(false, std::forward<Args>(args)...);
+                return ;
+            }
+            _construct(slot(count), std::forward<Args>(args)...);
+            ++count;
+        }
+
+        template <typename... Args>
+        void emplace_front(Args&&... args)
+        {
+            if(count == limit)
+            {
+                emplace_full(true, std::forward<Args>(args)...);
+                return ;
+            }
+            _construct(buf + ((head - 1) & mask), std::forward<Args>(args)...);
+            head = (head - 1) & mask;
+            ++count;
+        }
+
+        void pop_front()
+        {
+            _destroy(slot(0));
+            head = (head + 1) & mask;
+            --count;
+        }
+
+        void pop_back()
+        {
+            _destroy(slot(count - 1));
+            --count;
+        }
+
+        void clear()
+        {
+            for(size_type i=0; i<count; ++i) _destroy(slot(i));
+            head = count = 0;
+        }
+
+    protected:
+        void allocate_storage(size_type n)
+        {
+            buf = data_allocator::allocate(get_alloc(), n);
+            mask = n - 1;
+            limit = Capacity != 0 ? Capacity : n;
+        }
+
+        void deallocate_storage()
+        {
+            if(buf != nullptr) data_allocator::deallocate(get_alloc(), buf, mask + 1);
+            buf = nullptr;
+            mask = 0;
+            limit = 0;
+        }
+
+        // 还没有空间时先配置空间
+        // 满了以后的插入: 覆盖另一端的元素, 抛出异常, 或者扩大空间
+        // 新元素先构造出来, args可能引用将被覆盖或搬走的元素
+        template <typename... Args>
+        void emplace_full(bool at_front, Args&&... args)
+        {
+            if(buf == nullptr)
+            {
+                allocate_storage(Capacity != 0 ? round_up_pow2(Capacity) : size_type(__MIN_STORAGE));
+                if(at_front) emplace_front(std::forward<Args>(args)...);
+                else emplace_back(std::forward<Args>(args)...);
+                return ;
+            }
+            if(Capacity != 0 && !Overwrite) throw std::length_error("ring_buffer is full");
+            value_type x(std::forward<Args>(args)...);
+            if(Capacity != 0)
+            {
+                if(at_front)
+                {
+                    pop_back();
+                    emplace_front(std::move(x));
+                }
+                else
+                {
+                    pop_front();
+                    emplace_back(std::move(x));
+                }
+                return ;
+            }
+            reallocate(2*storage());
+            if(at_front) emplace_front(std::move(x));
+            else emplace_back(std::move(x));
+        }
+
+        // 元素按顺序搬到新空间的开头
+        void reallocate(size_type n)
+        {
+            T * new_buf = data_allocator::allocate(get_alloc(), n);
+            size_type i = 0;
+            try
+            {
+                for(; i<count; ++i) _construct(new_buf + i, std::move_if_noexcept(*slot(i)));
+            }
+            catch(...)
+            {
+                _destroy(new_buf, new_buf + i);
+                data_allocator::deallocate(get_alloc(), new_buf, n);
+                throw;
+            }
+            const size_type n_elems = count;
+            clear();
+            deallocate_storage();
+            buf = new_buf;
+            mask = n - 1;
+            limit = n;
+            count = n_elems;
+        }
+    };
+
+}
+
+#endif
@@ -36,7 +36,7 @@ namespace ltx
         typedef typename rep_type::difference_type difference_type;
 
         set() : t(Compare()) {}
-        explicit set(const Compare& comp) : t(comp) {}
+        explicit set(const Compare& comp, const Alloc& a = Alloc()) : t(comp, a) {}
 
         template <typename InputIterator>
         set(InputIterator first, InputIterator last) : t(Compare())
@@ -51,13 +51,23 @@ namespace ltx
             t.insert_unique(first, last);
         }
 
-        set(const set<Key, Compare, Alloc> &x) :t(x.t) {}
+        set(const set<Key, Compare, Alloc>& x) :t(x.t) {}
+        set(set<Key, Compare, Alloc>&& x) noexcept(std::is_nothrow_move_constructible<rep_type>::value)
+            :t(std::move(x.t)) {}
 
-        set<Key, Compare, Alloc>& operator= (const set<Key, Compare, Alloc>& x)
+        set<Key, Compare, Alloc>& operator=(const set<Key, Compare, Alloc>& x)
         {
             t = x.t;
             return *this;
         }
+        set<Key, Compare, Alloc>& operator=(set<Key, Compare, Alloc>&& x)
+            noexcept(std::is_nothrow_move_assignable<rep_type>::value)
+        {
+            t = std::move(x.t);
+            return *this;
+        }
+        void swap(set<Key, Compare, Alloc>& x) { t.swap(x.t); }
+        Alloc get_allocator() const { return t.get_allocator(); }
 
 
         // 以下所有方法都只是调用rb_tree中相应方法
@@ -68,7 +78,6 @@ namespace ltx
         bool empty() const { return t.empty(); }
         size_type size() const { return t.size(); }
         size_type max_size() const { return t.max_size(); }
-        // void swap(set<Key, Compare, Alloc>& x) { t.swap(x.t); }
 
         typedef pair<iterator, bool> pair_iterator_bool;
         pair_iterator_bool insert(const value_type& x)
@@ -0,0 +1,201 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include "vector.h"
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace ltx
+{
+    // small_vector使用的配置器, 对象内部带有一块能容纳N个T的缓冲区
+    // 缓冲区空闲且请求不超过缓冲区大小时返回缓冲区, 否则交给Alloc
+    // 复制配置器时只复制Alloc, 新配置器有自己的空缓冲区
+    template <typename T, size_t N, typename Alloc = alloc>
+    class small_buffer_alloc : private Alloc
+    {
+    private:
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type buf[N];
+        bool buf_used;
+
+    public:
+        small_buffer_alloc() : Alloc(), buf_used(false) {}
+        explicit small_buffer_alloc(const Alloc& a) : Alloc(a), buf_used(false) {}
+        small_buffer_alloc(const small_buffer_alloc& x) : Alloc(x.heap_alloc()), buf_used(false) {}
+        small_buffer_alloc& operator=(const small_buffer_alloc& x)
+        {
+            heap_alloc() = x.heap_alloc();
+            return *this;
+        }
+
+        void * allocate(size_t n)
+        {
+            if(!buf_used && n <= sizeof(buf))
+            {
+                buf_used = true;
+                return buf;
+            }
+            return heap_alloc().allocate(n);
+        }
+
+        void deallocate(void * p, size_t n)
+        {
+            if(is_inline(p)) buf_used = false;
+            else heap_alloc().deallocate(p, n);
+        }
+
+        bool is_inline(const void * p) const { return p == (const void*)buf; }
+
+        Alloc& heap_alloc() { return *this; }
+        const Alloc& heap_alloc() const { return *this; }
+
+        // 缓冲区属于对象本身, 不同的配置器不能释放对方配置的空间
+        bool operator==(const small_buffer_alloc& x) const { return this == &x; }
+        bool operator!=(const small_buffer_alloc& x) const { return this != &x; }
+    };
+
+    // 元素不超过N个时存放在对象内部, 超过后才从Alloc配置空间
+    // 插入, 删除, 增长都直接使用vector的实现, 只有复制, 移动和交换需要区分元素是否在对象内部
+    // 私有继承: vector的复制, 移动和swap只交换指针, 会让一个对象指向另一个对象内部的缓冲区, 不能通过vector&调用
+    template <typename T, size_t N, typename Alloc = alloc, typename Grow = grow_double>
+    class small_vector : private vector<T, small_buffer_alloc<T, N, Alloc>, Grow>
+    {
+    private:
+        typedef vector<T, small_buffer_alloc<T, N, Alloc>, Grow> base;
+        typedef small_buffer_alloc<T, N, Alloc> buffer_alloc;
+        using base::start;
+        using base::finish;
+        using base::end_of_storage;
+        using base::get_alloc;
+
+        // 元素移动不抛异常时, 移动和交换也不抛异常(只会用到对象内部的缓冲区)
+        enum {__NOTHROW_MOVE = std::is_nothrow_move_constructible<T>::value};
+
+    public:
+        using typename base::value_type;
+        using typename base::pointer;
+        using typename base::iterator;
+        using typename base::const_iterator;
+        using typename base::reference;
+        using typename base::const_reference;
+        using typename base::reverse_iterator;
+        using typename base::size_type;
+        using typename base::difference_type;
+
+        using base::begin;
+        using base::end;
+        using base::rbegin;
+        using base::rend;
+        using base::size;
+        using base::capacity;
+        using base::empty;
+        using base::reserve;
+        using base::operator[];
+        using base::get_allocator;
+        using base::front;
+        using base::back;
+        using base::push_back;
+        using base::emplace_back;
+        using base::emplace;
+        using base::insert;
+        using base::pop_back;
+        using base::erase;
+        using base::resize;
+        using base::resize_default_init;
+        using base::append_uninitialized;
+        using base::clear;
+
+        small_vector() { this->reserve(N); }
+        explicit small_vector(const Alloc& a) : base(buffer_alloc(a)) { this->reserve(N); }
+        small_vector(size_type n, const T& value, const Alloc& a = Alloc()) : base(buffer_alloc(a))
+        {
+            this->reserve(n > N ? n : N);
+            finish = ltx::uninitialized_fill_n(start, n, value);
+        }
+
+        small_vector(const small_vector& x) : base(buffer_alloc(x.get_alloc().heap_alloc()))
+        {
+            this->reserve(x.size() > N ? x.size() : N);
+            finish = ltx::uninitialized_copy(x.start, x.finish, start);
+        }
+
+        // x的元素在Alloc配置的空间中时直接接管, 否则逐个移动
+        small_vector(small_vector&& x) noexcept(__NOTHROW_MOVE) : base(buffer_alloc(x.get_alloc().heap_alloc()))
+        {
+            if(!x.is_inline())
+            {
+                take(x);
+                return ;
+            }
+            this->reserve(N);
+            finish = ltx::uninitialized_move(x.start, x.finish, start);
+            x.clear();
+        }
+
+        small_vector& operator=(const small_vector& x)
+        {
+            if(&x == this) return *this;
+            this->clear();
+            this->reserve(x.size());
+            finish = ltx::uninitialized_copy(x.start, x.finish, start);
+            return *this;
+        }
+
+        small_vector& operator=(small_vector&& x) noexcept(__NOTHROW_MOVE)
+        {
+            if(&x == this) return *this;
+            this->clear();
+            if(!x.is_inline())
+            {
+                // 先还回自己的空间, 再连同Alloc一起接管x的空间
+                this->deallocate();
+                get_alloc() = x.get_alloc();
+                take(x);
+                return *this;
+            }
+            this->reserve(x.size());
+            finish = ltx::uninitialized_move(x.start, x.finish, start);
+            x.clear();
+            return *this;
+        }
+
+        void swap(small_vector& x) noexcept(__NOTHROW_MOVE)
+        {
+            if(!is_inline() && !x.is_inline())
+            {
+                std::swap(start, x.start);
+                std::swap(finish, x.finish);
+                std::swap(end_of_storage, x.end_of_storage);
+                std::swap(get_alloc().heap_alloc(), x.get_alloc().heap_alloc());
+                return ;
+            }
+            small_vector tmp(std::move(x));
+            x = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        // 元素个数不超过N时搬回对象内部
+        void shrink_to_fit()
+        {
+            if(is_inline()) return ;
+            this->reallocate(this->size() > N ? this->size() : N);
+        }
+
+        // 元素是否存放在对象内部
+        bool is_inline() const { return get_alloc().is_inline(start); }
+
+    private:
+        // 接管x在Alloc中配置的空间, x改为使用自己的缓冲区
+        void take(small_vector& x)
+        {
+            start = x.start;
+            finish = x.finish;
+            end_of_storage = x.end_of_storage;
+            x.start = x.finish = x.end_of_storage = nullptr;
+            x.reserve(N);
+        }
+    };
+
+}
+
+#endif
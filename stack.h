@@ -3,9 +3,11 @@
 
 
 #include "deque.h"
+#include <utility>
 
 namespace ltx
 {
+    // Sequence可以是deque, vector, list或ring_buffer
     template <typename T, typename Sequence = deque<T>>
     class stack
     {
@@ -17,11 +19,16 @@ namespace ltx
     protected:
         Sequence c;
     public:
+        stack() : c() {}
+        explicit stack(const Sequence& s) : c(s) {}
+        explicit stack(Sequence&& s) : c(std::move(s)) {}
+
         bool empty() { return c.empty(); }
         size_type size() const { return c.size(); }
         reference top() { return c.back(); }
         const_reference top() const { return c.back(); }
         void push(const value_type& x) { c.push_back(x); }
+        void push(value_type&& x) { c.push_back(std::move(x)); }
         void pop() { c.pop_back(); }
     };
 }
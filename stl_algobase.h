@@ -1,6 +1,9 @@
 #ifndef STL_ALGOBASE_H
 #define STL_ALGOBASE_H
 
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
 #include "stl_iterator.h"
 namespace ltx
 {
@@ -17,6 +20,161 @@ namespace ltx
         __iter_swap(a, b, value_type(a));
     }
 
+    // 分段算法每段内部使用的复制, 不依赖<algorithm>
+    // 同类型的平凡元素之间直接memmove
+    template <typename InputIterator, typename OutputIterator>
+    inline OutputIterator __copy_span(InputIterator first, InputIterator last, OutputIterator result)
+    {
+        for(; first != last; ++first, ++result) *result = *first;
+        return result;
+    }
+    template <typename T, typename U>
+    inline typename std::enable_if<std::is_trivially_copyable<T>::value
+                                   && std::is_same<typename std::remove_cv<U>::type, T>::value, T*>::type
+    __copy_span(U * first, U * last, T * result)
+    {
+        const size_t n = last - first;
+        if(n != 0) std::memmove(result, first, n*sizeof(T));
+        return result + n;
+    }
+
+    // 对[first, last)中的每段连续空间调用op(段, 段内首, 段内尾), op返回false时停止
+    template <typename SegmentedIterator, typename Op>
+    void __for_each_segment(SegmentedIterator first, SegmentedIterator last, Op op)
+    {
+        typedef segmented_iterator_traits<SegmentedIterator> traits;
+        typename traits::segment_iterator sfirst = traits::segment(first);
+        typename traits::segment_iterator slast = traits::segment(last);
+        if(sfirst == slast)
+        {
+            op(sfirst, traits::local(first), traits::local(last));
+            return ;
+        }
+        if(!op(sfirst, traits::local(first), traits::end(sfirst))) return ;
+        for(++sfirst; sfirst != slast; ++sfirst)
+            if(!op(sfirst, traits::begin(sfirst), traits::end(sfirst))) return ;
+        op(slast, traits::begin(slast), traits::local(last));
+    }
+
+    // 复制到分段迭代器, 按目标的段拆分源区间
+    template <typename RandomAccessIterator, typename SegmentedIterator>
+    SegmentedIterator __copy_to_segmented(RandomAccessIterator first, RandomAccessIterator last,
+                                          SegmentedIterator result)
+    {
+        // 空区间不访问目标的段, 目标可能是没有缓冲区的空迭代器
+        if(first == last) return result;
+        typedef segmented_iterator_traits<SegmentedIterator> traits;
+        typename traits::segment_iterator s = traits::segment(result);
+        typename traits::local_iterator l = traits::local(result);
+        for(;;)
+        {
+            ptrdiff_t room = traits::end(s) - l;
+            ptrdiff_t n = last - first;
+            if(n <= room) return traits::compose(s, __copy_span(first, last, l));
+            __copy_span(first, first + room, l);
+            first += room;
+            ++s;
+            l = traits::begin(s);
+        }
+    }
+
+    // 复制到result, 第四个参数为true时按result的段拆分(要求源区间可随机访问)
+    template <typename InputIterator, typename OutputIterator>
+    inline OutputIterator __copy_into(InputIterator first, InputIterator last, OutputIterator result, std::false_type)
+    {
+        return __copy_span(first, last, result);
+    }
+    template <typename RandomAccessIterator, typename OutputIterator>
+    inline OutputIterator __copy_into(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result,
+                                      std::true_type)
+    {
+        return __copy_to_segmented(first, last, result);
+    }
+
+    // 从分段区间复制, 每段是一次指针区间的复制
+    template <typename SegmentedIterator, typename OutputIterator>
+    OutputIterator __segmented_copy(SegmentedIterator first, SegmentedIterator last, OutputIterator result)
+    {
+        typedef segmented_iterator_traits<SegmentedIterator> traits;
+        typedef typename traits::segment_iterator segment_iterator;
+        typedef typename traits::local_iterator local_iterator;
+        typedef std::integral_constant<bool, segmented_iterator_traits<OutputIterator>::is_segmented> segmented;
+        __for_each_segment(first, last, [&](segment_iterator, local_iterator p, local_iterator q)
+        {
+            result = __copy_into(p, q, result, segmented());
+            return true;
+        });
+        return result;
+    }
+
+    // 任意迭代器之间的复制, 容器内部使用
+    // 源或目标是分段迭代器时按段处理, 否则逐个复制
+    template <typename InputIterator, typename OutputIterator>
+    inline OutputIterator __copy(InputIterator first, InputIterator last, OutputIterator result, std::true_type)
+    {
+        return __segmented_copy(first, last, result);
+    }
+    template <typename InputIterator, typename OutputIterator>
+    inline OutputIterator __copy(InputIterator first, InputIterator last, OutputIterator result, std::false_type)
+    {
+        typedef std::integral_constant<bool, segmented_iterator_traits<OutputIterator>::is_segmented
+                                             && __is_random_access_iterator<InputIterator>::value> segmented;
+        return __copy_into(first, last, result, segmented());
+    }
+    template <typename InputIterator, typename OutputIterator>
+    inline OutputIterator __copy(InputIterator first, InputIterator last, OutputIterator result)
+    {
+        typedef std::integral_constant<bool, segmented_iterator_traits<InputIterator>::is_segmented> segmented;
+        return __copy(first, last, result, segmented());
+    }
+
+    template <typename SegmentedIterator, typename T>
+    void __segmented_fill(SegmentedIterator first, SegmentedIterator last, const T& value)
+    {
+        typedef segmented_iterator_traits<SegmentedIterator> traits;
+        typedef typename traits::segment_iterator segment_iterator;
+        typedef typename traits::local_iterator local_iterator;
+        __for_each_segment(first, last, [&](segment_iterator, local_iterator p, local_iterator q)
+        {
+            for(; p != q; ++p) *p = value;
+            return true;
+        });
+    }
+
+    template <typename SegmentedIterator, typename T>
+    SegmentedIterator __segmented_find(SegmentedIterator first, SegmentedIterator last, const T& value)
+    {
+        typedef segmented_iterator_traits<SegmentedIterator> traits;
+        typedef typename traits::segment_iterator segment_iterator;
+        typedef typename traits::local_iterator local_iterator;
+        SegmentedIterator result = last;
+        __for_each_segment(first, last, [&](segment_iterator s, local_iterator p, local_iterator q)
+        {
+            for(; p != q; ++p)
+                if(*p == value)
+                {
+                    result = traits::compose(s, p);
+                    return false;
+                }
+            return true;
+        });
+        return result;
+    }
+
+    template <typename SegmentedIterator, typename Function>
+    Function __segmented_for_each(SegmentedIterator first, SegmentedIterator last, Function f)
+    {
+        typedef segmented_iterator_traits<SegmentedIterator> traits;
+        typedef typename traits::segment_iterator segment_iterator;
+        typedef typename traits::local_iterator local_iterator;
+        __for_each_segment(first, last, [&](segment_iterator, local_iterator p, local_iterator q)
+        {
+            for(; p != q; ++p) f(*p);
+            return true;
+        });
+        return f;
+    }
+
     
 } // namespace ltx
 
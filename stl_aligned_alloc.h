@@ -0,0 +1,87 @@
+#ifndef STL_ALIGNED_ALLOC_H
+#define STL_ALIGNED_ALLOC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include "stl_alloc.h"
+#include "memory.h"
+
+namespace ltx
+{
+    enum {__CACHE_LINE = 64};      // 缓存行大小, 用来避免伪共享
+
+    // 对齐配置器
+    // 通过simple_alloc<T, align_alloc<Align>>配置时, 对齐值取Align和alignof(T)中较大者
+    // Align为0表示完全跟随alignof(T); 直接调用allocate(n)时按Align(至少__ALIGN)对齐
+    // 对齐值不超过__ALIGN的请求交给default_alloc, 否则多配置一些空间再调整起点,
+    // 原始指针保存在返回地址之前, 释放时取回
+    template <size_t Align = 0>
+    class align_alloc
+    {
+        static_assert((Align & (Align-1)) == 0, "alignment must be a power of two");
+
+    public:
+        enum {alignment = Align};
+
+        static void * allocate(size_t n, size_t align)
+        {
+            if(align <= (size_t)__ALIGN) return default_alloc::allocate(n);
+            char * raw = (char*) base_alloc::allocate(n + align - 1 + sizeof(void*));
+            char * result = (char*)(((std::uintptr_t)raw + sizeof(void*) + align - 1) & ~(std::uintptr_t)(align - 1));
+            ((void**)result)[-1] = raw;
+            return result;
+        }
+
+        static void deallocate(void * p, size_t n, size_t align)
+        {
+            if(align <= (size_t)__ALIGN)
+            {
+                default_alloc::deallocate(p, n);
+                return ;
+            }
+            base_alloc::deallocate(((void**)p)[-1], n + align - 1 + sizeof(void*));
+        }
+
+        static void * allocate(size_t n) { return allocate(n, Align); }
+        static void deallocate(void * p, size_t n) { deallocate(p, n, Align); }
+    };
+
+    // 缓存行对齐的配置器, 用于按线程划分的计数器等
+    typedef align_alloc<__CACHE_LINE> cache_aligned_alloc;
+
+    // 容器通过simple_alloc配置空间, 在这里把alignof(T)传给align_alloc
+    template <typename T, size_t Align>
+    class simple_alloc<T, align_alloc<Align> >
+    {
+    private:
+        typedef align_alloc<Align> Alloc;
+        enum {align = Align > alignof(T) ? Align : alignof(T)};
+
+    public:
+        static T * allocate(size_t n)
+        {
+            return 0==n ? nullptr : (T*)Alloc::allocate(n*sizeof(T), align);
+        }
+        static T * allocate(void)
+        {
+            return (T*) Alloc::allocate(sizeof(T), align);
+        }
+        static void deallocate(T*p, size_t n)
+        {
+            if(0!=n) Alloc::deallocate(p, n*sizeof(T), align);
+        }
+        static void deallocate(T *p)
+        {
+            Alloc::deallocate(p, sizeof(T), align);
+        }
+
+        static T * allocate(Alloc &, size_t n) { return allocate(n); }
+        static T * allocate(Alloc &) { return allocate(); }
+        static void deallocate(Alloc &, T *p, size_t n) { deallocate(p, n); }
+        static void deallocate(Alloc &, T *p) { deallocate(p); }
+    };
+
+}
+
+#endif
@@ -2,6 +2,11 @@
 #define STL_ALLOC_H
 
 #include <cstddef>
+#include <ostream>
+#include <type_traits>
+#ifdef LTX_ALLOC_TRACE
+#include "stl_alloc_trace.h"
+#endif
 // #define DEBUG
 #undef DEBUG
 #ifdef DEBUG
@@ -10,6 +15,12 @@ using namespace std;
 #endif
 namespace ltx
 {
+    // 定义LTX_ALLOC_TRACE后记录base_alloc和default_alloc的每次配置/释放, 见stl_alloc_trace.h
+#ifdef LTX_ALLOC_TRACE
+#define __ALLOC_TRACE(op, p, n) alloc_trace::record(op, p, n)
+#else
+#define __ALLOC_TRACE(op, p, n)
+#endif
     
     // 一级配置器
     class base_alloc
@@ -18,19 +29,200 @@ namespace ltx
         static void * allocate(size_t n)
         {
             void * result = ::operator new(n);
+            __ALLOC_TRACE(__TRACE_ALLOC, result, n);
             return result;
         }
-        static void deallocate(void * p, size_t)
+        static void deallocate(void * p, size_t n)
         {
+            __ALLOC_TRACE(__TRACE_FREE, p, n);
             ::operator delete(p);
         }
 
     };
 
     // 二级配置器
+    // 默认只负责128字节以内的区块, 与SGI相同
+    // 可在包含本文件前定义LTX_ALLOC_MAX_BYTES(不小于128的2的幂, 如4096)让二级配置器按分级管理更大的区块
+#ifndef LTX_ALLOC_MAX_BYTES
+#define LTX_ALLOC_MAX_BYTES 128
+#endif
+
+    constexpr int __alloc_log2(size_t n) { return n <= 1 ? 0 : 1 + __alloc_log2(n/2); }
+
     enum {__ALIGN = 8};     // 小区快上调边界
-    enum {__MAX_BYTES = 128};       // 小区快上限
-    enum {__NFREELISTS = __MAX_BYTES/__ALIGN};      // free-list 个数
+    enum {__SMALL_BYTES = 128};     // 此上限以内按__ALIGN等距分级
+    enum {__CLASS_STEPS = 8};       // 此上限以上每个2倍区间等分的级数, 内部碎片不超过1/8
+    enum {__MAX_BYTES = LTX_ALLOC_MAX_BYTES};       // 小区快上限
+    enum {__NFREELISTS = __SMALL_BYTES/__ALIGN 
+        + __CLASS_STEPS*__alloc_log2(__MAX_BYTES/__SMALL_BYTES)};      // free-list 个数
+
+    static_assert((size_t)__MAX_BYTES >= (size_t)__SMALL_BYTES && (__MAX_BYTES & (__MAX_BYTES-1)) == 0,
+        "LTX_ALLOC_MAX_BYTES must be a power of two no less than 128");
+
+    // 区块大小分级
+    // 8~128字节按8字节分16级; 之后每个2倍区间分8级, 如144, 160, ..., 256, 288, 320, ..., 512
+    // 这样请求大小与区块大小之差不超过区块大小的12.5%
+    struct size_class
+    {
+        // 根据区块大小决定使用哪个free-list
+        static size_t index(size_t bytes)
+        {
+            if(bytes <= (size_t)__SMALL_BYTES) return (bytes+__ALIGN-1)/__ALIGN - 1;
+            int lg = floor_log2(bytes-1);       // bytes位于(2^lg, 2^(lg+1)]
+            int shift = lg - __alloc_log2(__CLASS_STEPS);
+            return __SMALL_BYTES/__ALIGN 
+                + (lg - __alloc_log2(__SMALL_BYTES))*__CLASS_STEPS
+                + ((bytes-1-(size_t(1)<<lg)) >> shift);
+        }
+
+        // 第index个free-list的区块大小
+        static size_t size(size_t index)
+        {
+            if(index < (size_t)(__SMALL_BYTES/__ALIGN)) return (index+1)*__ALIGN;
+            size_t group = (index - __SMALL_BYTES/__ALIGN) / __CLASS_STEPS;
+            size_t step = (index - __SMALL_BYTES/__ALIGN) % __CLASS_STEPS;
+            size_t base = size_t(__SMALL_BYTES) << group;
+            return base + (step+1)*(base/__CLASS_STEPS);
+        }
+
+        // 将bytes上调至所在级的区块大小
+        static size_t round_up(size_t bytes) { return size(index(bytes)); }
+
+        // 一批区块最多占用的字节数, 避免大区块一次切分太多
+        enum {__BATCH_BYTES = 32*1024};
+        static int batch_limit(size_t index, int nobjs)
+        {
+            int limit = int(__BATCH_BYTES / size(index));
+            if(limit < 1) limit = 1;
+            return nobjs < limit ? nobjs : limit;
+        }
+
+        // 不超过bytes的最大区块大小所在的级, bytes须为__ALIGN的倍数
+        static size_t index_floor(size_t bytes)
+        {
+            size_t i = index(bytes);
+            return size(i) > bytes ? i-1 : i;
+        }
+
+        static int floor_log2(size_t n)
+        {
+#if defined(__GNUC__)
+            return int(sizeof(unsigned long long)*8 - 1) - __builtin_clzll(n);
+#else
+            int lg = 0;
+            while(n >>= 1) ++lg;
+            return lg;
+#endif
+        }
+    };
+
+    // 二级配置器内存池的公共操作, default_alloc, memory_pool和thread_alloc共用
+    // free-list的节点类型由各配置器自己定义, 只要求有free_list_link成员
+    struct __pool_ops
+    {
+        // 从[start_free, end_free)中切出最多nobjs个大小为size的区块, nobj改为实际个数
+        // 一个区块都切不出时返回nullptr
+        static char * carve(char *& start_free, char * end_free, size_t size, int & nobjs)
+        {
+            size_t bytes_left = end_free - start_free;
+            if(bytes_left < size) return nullptr;
+            if(bytes_left < size*nobjs) nobjs = int(bytes_left/size);
+            char * result = start_free;
+            start_free += size*nobjs;
+            return result;
+        }
+
+        // 内存池不够时新配置的字节数=2倍请求的空间+一个数值
+        // 其中ROUND_UP(heap_size>>4)这一项的目的是让每次配置空间都比之前大一些
+        static size_t chunk_bytes(size_t total_bytes, size_t heap_size)
+        {
+            return 2*total_bytes + (((heap_size>>4)+__ALIGN-1) & ~size_t(__ALIGN-1));
+        }
+
+        // 把从p开始的count个大小为n的区块串起来放到head之前
+        template <typename Head>
+        static void link_blocks(Head & head, char * p, size_t n, int count)
+        {
+            typedef typename std::remove_cv<Head>::type obj_ptr;
+            if(count <= 0) return ;
+            for(int i=1; i<count; ++i, p += n) ((obj_ptr)p)->free_list_link = (obj_ptr)(p+n);
+            ((obj_ptr)p)->free_list_link = head;
+            head = (obj_ptr)(p - (count-1)*n);
+        }
+
+        // 内存池剩余的零头按能放下的最大区块逐个切分, 放到相应的free-list中
+        template <typename Head>
+        static void spill(Head * free_list, char *& start_free, char * end_free)
+        {
+            size_t bytes_left = end_free - start_free;
+            while(bytes_left > 0)
+            {
+                size_t index = size_class::index_floor(bytes_left);
+                link_blocks(free_list[index], start_free, size_class::size(index), 1);
+                start_free += size_class::size(index);
+                bytes_left -= size_class::size(index);
+            }
+        }
+    };
+
+    // 定义LTX_ALLOC_STATS后default_alloc才会计数, 否则计数代码全部不参与编译
+#ifdef LTX_ALLOC_STATS
+#define __ALLOC_STAT(stmt) stmt
+#else
+#define __ALLOC_STAT(stmt)
+#endif
+
+    // 一个free-list的统计信息
+    struct alloc_class_stats
+    {
+        size_t block_size;      // 区块大小
+        size_t allocations;     // 配置次数
+        size_t deallocations;   // 释放次数
+        size_t free_blocks;     // 当前free-list上的区块数
+        size_t refills;         // refill次数
+        size_t refill_batch;    // 最近一次refill的批量大小
+    };
+
+    // default_alloc的统计快照
+    // free_blocks, heap_size, pool_bytes随时可用, 其余计数需要定义LTX_ALLOC_STATS
+    struct alloc_stats
+    {
+        bool enabled;                   // 是否定义了LTX_ALLOC_STATS
+        alloc_class_stats classes[__NFREELISTS];
+        size_t large_allocations;       // 交给一级配置器的配置次数
+        size_t large_deallocations;     // 交给一级配置器的释放次数
+        size_t chunk_allocs;            // chunk_alloc调用次数
+        size_t heap_size;               // 内存池从堆中获取的总字节数
+        size_t pool_bytes;              // 内存池中还未切分的字节数
+        size_t bytes_in_use;            // 用户持有的字节数(按区块大小计)
+        size_t high_water;              // bytes_in_use的最大值
+
+        // 以JSON格式输出
+        void dump_json(std::ostream & os) const
+        {
+            os << "{\"enabled\":" << (enabled ? "true" : "false")
+               << ",\"heap_size\":" << heap_size
+               << ",\"pool_bytes\":" << pool_bytes
+               << ",\"chunk_allocs\":" << chunk_allocs
+               << ",\"bytes_in_use\":" << bytes_in_use
+               << ",\"high_water\":" << high_water
+               << ",\"large\":{\"allocations\":" << large_allocations
+               << ",\"deallocations\":" << large_deallocations << "}"
+               << ",\"classes\":[";
+            for(int i=0; i<__NFREELISTS; ++i)
+            {
+                const alloc_class_stats & c = classes[i];
+                if(i != 0) os << ",";
+                os << "{\"size\":" << c.block_size
+                   << ",\"allocations\":" << c.allocations
+                   << ",\"deallocations\":" << c.deallocations
+                   << ",\"free_blocks\":" << c.free_blocks
+                   << ",\"refills\":" << c.refills
+                   << ",\"refill_batch\":" << c.refill_batch << "}";
+            }
+            os << "]}";
+        }
+    };
 
     class default_alloc
     {
@@ -54,7 +246,7 @@ namespace ltx
         // 根据区块大小决定使用哪个free-list
         static size_t FREELIST_INDEX(size_t bytes)
         {
-            return ((bytes+__ALIGN-1)/__ALIGN - 1);
+            return size_class::index(bytes);
         }
 
     public:
@@ -63,16 +255,27 @@ namespace ltx
             obj * volatile * my_free_list;
             obj * result;
 
-            if(n > (size_t)__MAX_BYTES) return base_alloc::allocate(n);
+            // 统计在取得区块之后记录, 配置失败抛出bad_alloc时不计入
+            if(n > (size_t)__MAX_BYTES) 
+            {
+                void * r = base_alloc::allocate(n);
+                __ALLOC_STAT(record_large(n, true));
+                return r;
+            }
 
-            my_free_list = free_list + FREELIST_INDEX(n);
+            size_t index = FREELIST_INDEX(n);
+            my_free_list = free_list + index;
             result = *my_free_list;
             if(nullptr == result)
             {
-                void * r = refill(ROUND_UP(n));
+                void * r = refill(size_class::size(index));
+                __ALLOC_STAT(record(index, true));
+                __ALLOC_TRACE(__TRACE_ALLOC, r, n);
                 return r;
             }
             *my_free_list = result->free_list_link;
+            __ALLOC_STAT(record(index, true));
+            __ALLOC_TRACE(__TRACE_ALLOC, result, n);
             return result;
         }
         static void deallocate(void *p, size_t n)
@@ -82,14 +285,193 @@ namespace ltx
 
             if(n > (size_t)__MAX_BYTES) 
             {
+                __ALLOC_STAT(record_large(n, false));
                 base_alloc::deallocate(p, n);
                 return ;
             }
 
-            my_free_list = free_list + FREELIST_INDEX(n);
+            size_t index = FREELIST_INDEX(n);
+            __ALLOC_STAT(record(index, false));
+            __ALLOC_TRACE(__TRACE_FREE, p, n);
+            my_free_list = free_list + index;
             q->free_list_link = *my_free_list;
             *my_free_list = q;
+
+            // 自动归还策略: 每释放trim_interval次检查一次空闲的大块
+            // 每次最多扫描trim_interval*__TRIM_SCAN_FACTOR个空闲区块, 平摊到每次释放上的代价有上限
+            if(trim_interval != 0 && ++frees_since_trim >= trim_interval)
+                trim(trim_interval*__TRIM_SCAN_FACTOR);
+        }
+
+        // 把所有区块都已回到free-list(或还在内存池中未切分)的大块还给系统
+        // 返回归还的字节数
+        // max_scan限制扫描的空闲区块数, free-list更长时放弃本次归还
+        // 不配置内存, 不会抛出异常, 可以在释放路径上调用
+        static size_t trim(size_t max_scan = size_t(-1))
+        {
+            frees_since_trim = 0;
+            if(chunk_count == 0) return 0;
+
+            // 按地址排序, 以便二分查找区块所在的大块
+            // 空间在新增大块时已经备好; 新大块在链表头部, 地址通常较高, 倒着填入后接近有序
+            chunk_info * info = trim_scratch;
+            const size_t nchunks = chunk_count;
+            size_t k = nchunks;
+            for(chunk_header * c = chunks; c != nullptr; c = c->next)
+            {
+                --k;
+                info[k].header = c;
+                info[k].begin = c->data();
+                info[k].end = c->data() + c->size;
+                info[k].free_bytes = 0;
+            }
+            sort_chunks(info, nchunks);
+
+            // 统计每个大块中空闲的字节数
+            size_t scanned = 0;
+            for(int i=0; i<__NFREELISTS; ++i)
+            {
+                for(obj * p = free_list[i]; p != nullptr; p = p->free_list_link)
+                {
+                    if(++scanned > max_scan) return 0;
+                    chunk_info * ci = find_chunk(info, nchunks, (char*)p);
+                    if(ci != nullptr) ci->free_bytes += size_class::size(i);
+                }
+            }
+            chunk_info * pool_chunk = nullptr;
+            if(start_free != end_free)
+            {
+                pool_chunk = find_chunk(info, nchunks, start_free);
+                if(pool_chunk != nullptr) pool_chunk->free_bytes += end_free - start_free;
+            }
+
+            size_t released = 0;
+            for(k=0; k<nchunks; ++k)
+                if(info[k].free_bytes == info[k].header->size) released += info[k].free_bytes;
+
+            if(released != 0)
+            {
+                // 从free-list中摘掉位于待归还大块中的区块
+                for(int i=0; i<__NFREELISTS; ++i)
+                {
+                    obj * volatile * link = free_list + i;
+                    while(*link != nullptr)
+                    {
+                        chunk_info * ci = find_chunk(info, nchunks, (char*)*link);
+                        if(ci != nullptr && ci->free_bytes == ci->header->size)
+                            *link = (*link)->free_list_link;
+                        else link = &(*link)->free_list_link;
+                    }
+                }
+                if(pool_chunk != nullptr && pool_chunk->free_bytes == pool_chunk->header->size)
+                    start_free = end_free = 0;
+
+                // 归还大块
+                chunk_header ** link = &chunks;
+                while(*link != nullptr)
+                {
+                    chunk_header * c = *link;
+                    chunk_info * ci = find_chunk(info, nchunks, c->data());
+                    if(ci->free_bytes == c->size)
+                    {
+                        *link = c->next;
+                        heap_size -= c->size;
+                        --chunk_count;
+                        ::operator delete(c);
+                    }
+                    else link = &c->next;
+                }
+            }
+            return released;
+        }
+
+        // 每释放n次自动调用一次trim, n为0时关闭(默认)
+        static void set_trim_interval(size_t n)
+        {
+            trim_interval = n;
+            frees_since_trim = 0;
+        }
+
+        // 返回统计快照
+        static alloc_stats stats()
+        {
+            alloc_stats s = alloc_stats();
+            for(int i=0; i<__NFREELISTS; ++i)
+            {
+                alloc_class_stats & c = s.classes[i];
+                c.block_size = size_class::size(i);
+                c.refill_batch = refill_batch[i];
+                for(obj * p = free_list[i]; p != nullptr; p = p->free_list_link)
+                    ++c.free_blocks;
+            }
+            s.heap_size = heap_size;
+            s.pool_bytes = end_free - start_free;
+#ifdef LTX_ALLOC_STATS
+            s.enabled = true;
+            for(int i=0; i<__NFREELISTS; ++i)
+            {
+                s.classes[i].allocations = counters.allocations[i];
+                s.classes[i].deallocations = counters.deallocations[i];
+                s.classes[i].refills = counters.refills[i];
+            }
+            s.large_allocations = counters.large_allocations;
+            s.large_deallocations = counters.large_deallocations;
+            s.chunk_allocs = counters.chunk_allocs;
+            s.bytes_in_use = counters.bytes_in_use;
+            s.high_water = counters.high_water;
+#endif
+            return s;
+        }
+
+#ifdef LTX_ALLOC_STATS
+    private:
+        struct stat_counters
+        {
+            size_t allocations[__NFREELISTS];
+            size_t deallocations[__NFREELISTS];
+            size_t refills[__NFREELISTS];
+            size_t large_allocations;
+            size_t large_deallocations;
+            size_t chunk_allocs;
+            size_t bytes_in_use;
+            size_t high_water;
+        };
+        static stat_counters counters;
+
+        static void add_in_use(size_t bytes)
+        {
+            counters.bytes_in_use += bytes;
+            if(counters.bytes_in_use > counters.high_water) 
+                counters.high_water = counters.bytes_in_use;
         }
+        static void record(size_t index, bool is_alloc)
+        {
+            if(is_alloc)
+            {
+                ++counters.allocations[index];
+                add_in_use(size_class::size(index));
+            }
+            else 
+            {
+                ++counters.deallocations[index];
+                counters.bytes_in_use -= size_class::size(index);
+            }
+        }
+        static void record_large(size_t n, bool is_alloc)
+        {
+            if(is_alloc)
+            {
+                ++counters.large_allocations;
+                add_in_use(n);
+            }
+            else 
+            {
+                ++counters.large_deallocations;
+                counters.bytes_in_use -= n;
+            }
+        }
+#endif
+
     // friend void main();
     // 内存池
     private:
@@ -97,6 +479,66 @@ namespace ltx
         static char *start_free;
         static char *end_free;
         static size_t heap_size; // 作用见chunk_allo函数
+
+        // 每个从堆中获取的大块头部都有一个chunk_header, 所有大块串成一个链表, trim时使用
+        struct chunk_header
+        {
+            chunk_header * next;
+            size_t size;        // 头部之后可切分的字节数
+            char * data() { return (char*)(this+1); }
+        };
+        static chunk_header * chunks;
+        static size_t chunk_count;
+        static size_t trim_interval;
+        static size_t frees_since_trim;
+        enum {__TRIM_SCAN_FACTOR = 8};
+
+        struct chunk_info
+        {
+            chunk_header * header;
+            char * begin;
+            char * end;
+            size_t free_bytes;
+        };
+        // trim用的排序空间, 容量不小于chunk_count
+        static chunk_info * trim_scratch;
+        static size_t trim_capacity;
+
+        // 插入排序, 大块数量不多且基本有序
+        static void sort_chunks(chunk_info * info, size_t n)
+        {
+            for(size_t i=1; i<n; ++i)
+            {
+                chunk_info x = info[i];
+                size_t j = i;
+                for(; j>0 && x.begin < info[j-1].begin; --j) info[j] = info[j-1];
+                info[j] = x;
+            }
+        }
+        // 新增大块之前调用, 保证trim时不需要配置内存
+        static void reserve_scratch(size_t n)
+        {
+            if(n <= trim_capacity) return ;
+            size_t new_capacity = trim_capacity != 0 ? 2*trim_capacity : 8;
+            if(new_capacity < n) new_capacity = n;
+            chunk_info * p = (chunk_info*) ::operator new(new_capacity*sizeof(chunk_info));
+            ::operator delete(trim_scratch);
+            trim_scratch = p;
+            trim_capacity = new_capacity;
+        }
+        // 在按地址排好序的大块中找到p所在的那个
+        static chunk_info * find_chunk(chunk_info * info, size_t n, char * p)
+        {
+            size_t lo = 0, hi = n;
+            while(lo < hi)
+            {
+                size_t mid = (lo+hi)/2;
+                if(info[mid].begin <= p) lo = mid+1;
+                else hi = mid;
+            }
+            if(lo == 0 || p >= info[lo-1].end) return nullptr;
+            return info + lo - 1;
+        }
         
         // 配置一大块空间, 可容纳nobjs个大小为size的区块
         // 如果空间不够但足够供应一个及一个以上的区块, 那就只供应能供应的数量, 并将nobj的值改变为供应数量
@@ -108,64 +550,42 @@ namespace ltx
             cout << "(" << (void*)start_free << "-" << (void*)end_free << endl;
             #endif
 
-            char * result;
-            size_t total_bytes = size*nobjs;
-            size_t bytes_left = end_free - start_free;
-
-            if(bytes_left >= total_bytes)
-            {
-                result = start_free;
-                start_free += total_bytes;
-                return result;
-            }
-            else if(bytes_left >= size)
-            {
-                nobjs = bytes_left/size;
-                total_bytes = size*nobjs;
-                result = start_free;
-                start_free += total_bytes;
-                return result;
-            }
+            __ALLOC_STAT(++counters.chunk_allocs);
+            char * result = __pool_ops::carve(start_free, end_free, size, nobjs);
+            if(result != nullptr) return result;
             else 
             {
             //一个区块都无法提供
-                // 需要新配置空间的大小=2倍请求的空间+一个数值
-                // 其中ROUND_UP(heap_size>>4)这一项的目的是让每次配置空间都比之前大一些
-                size_t bytes_to_get = 2*total_bytes + ROUND_UP(heap_size>>4);
+                size_t bytes_to_get = __pool_ops::chunk_bytes(size*nobjs, heap_size);
                     #ifdef DEBUG
                     cout << "DEBUG chunk" << endl;
                     cout<< endl << "bytetoget" << bytes_to_get << " "  << endl;
                     #endif
                 // 让内存池中的空间利用起来(放到free_list中)
-                if(bytes_left > 0)
-                {
-                    // volatile 锁住 *my_free_list, 也就是free_list数组中的个元素
-                    // 网上说是为了多线程情况
-                    // 但volatile并不能保证多线程下不被别的线程改变, 可能是个历史遗留问题
-                    obj * volatile * my_free_list = free_list + FREELIST_INDEX(bytes_left);
-                    ((obj*)start_free)->free_list_link = *my_free_list;
-                    *my_free_list = (obj*)start_free;
-                }
+                // 区块大小不再是8的倍数全覆盖, 零头按能放下的最大区块逐个切分
+                __pool_ops::spill(free_list, start_free, end_free);
 
                 // 从堆中获取内存
+                chunk_header * c;
                 try
                 {
-                    start_free = (char*) ::operator new(bytes_to_get);
+                    reserve_scratch(chunk_count + 1);
+                    c = (chunk_header*) ::operator new(sizeof(chunk_header) + bytes_to_get);
                 }
                 // catch(std::bad_alloc)
                 catch(std::bad_alloc e)
                 {
-                    int i;
+                    size_t i;
                     obj *volatile *my_free_list, *p;
-                    for(i=size; i<=__MAX_BYTES; i+=__ALIGN)
+                    for(i=FREELIST_INDEX(size); i<(size_t)__NFREELISTS; ++i)
                     {
-                        my_free_list = free_list + FREELIST_INDEX(i);
+                        my_free_list = free_list + i;
                         p = *my_free_list;
                         if(p != nullptr)
                         {
                             *my_free_list = p->free_list_link;
                             start_free = (char*)p;
-                            end_free = start_free+i;
+                            end_free = start_free+size_class::size(i);
                                 #ifdef DEBUG
                                 cout << "ddd" <<endl;   
                                 #endif
@@ -175,6 +595,11 @@ namespace ltx
                     end_free = 0;
                     throw e;
                 }
+                c->size = bytes_to_get;
+                c->next = chunks;
+                chunks = c;
+                ++chunk_count;
+                start_free = c->data();
                 heap_size += bytes_to_get;
                 end_free = start_free+bytes_to_get;
                 return chunk_alloc(size, nobjs);
@@ -182,14 +607,51 @@ namespace ltx
             }
         }
 
+        // refill批量大小自适应
+        // 用refill次数作时钟, 某个free-list距上次refill的间隔很短说明它很热, 批量翻倍
+        // 间隔很长说明它很冷, 批量减半, 避免大量区块闲置在冷门的free-list上
+        // 批量上限按字节计算, 大区块的批量相应更小
+        // 定义LTX_ALLOC_FIXED_REFILL则和原来一样固定为20个
+        enum {__REFILL_INIT = 20};
+        enum {__REFILL_MIN = 4};
+        enum {__REFILL_MAX = 1024};
+        enum {__REFILL_MAX_BYTES = size_class::__BATCH_BYTES};
+        enum {__REFILL_HOT_GAP = __NFREELISTS};
+        enum {__REFILL_COLD_GAP = 4*__NFREELISTS};
+
+        static int refill_batch[__NFREELISTS];
+        static size_t last_refill[__NFREELISTS];
+        static size_t refill_clock;
+
+        static int next_batch(size_t index)
+        {
+#ifdef LTX_ALLOC_FIXED_REFILL
+            return __REFILL_INIT;
+#else
+            int & batch = refill_batch[index];
+            ++refill_clock;
+            if(batch == 0) batch = __REFILL_INIT;
+            else 
+            {
+                size_t gap = refill_clock - last_refill[index];
+                if(gap <= (size_t)__REFILL_HOT_GAP) batch *= 2;
+                else if(gap > (size_t)__REFILL_COLD_GAP) batch /= 2;
+                if(batch < __REFILL_MIN) batch = __REFILL_MIN;
+            }
+            int max_batch = __REFILL_MAX_BYTES / size_class::size(index);
+            if(max_batch > __REFILL_MAX) max_batch = __REFILL_MAX;
+            if(max_batch < 1) max_batch = 1;
+            if(batch > max_batch) batch = max_batch;
+            last_refill[index] = refill_clock;
+            return batch;
+#endif
+        }
+
         static void * refill(size_t n)
         {
-            int nobjs = 20;
+            int nobjs = next_batch(FREELIST_INDEX(n));
+            __ALLOC_STAT(++counters.refills[FREELIST_INDEX(n)]);
             char * chunk = chunk_alloc(n, nobjs);
-            obj * volatile * my_free_list;
-            obj * result;
-            obj * current_obj, * next_obj;
-            int i;
             #ifdef DEBUG
             cout << "DEBUG refil" << endl;
             cout<< endl << (obj*)chunk << " " << nobjs << endl;
@@ -199,26 +661,8 @@ namespace ltx
             if(nobjs == 1) return chunk;
 
             // 调整free_list, 纳入新节点
-            my_free_list = free_list + FREELIST_INDEX(n);
-            result = (obj*) chunk;
-
-            *my_free_list = next_obj = (obj*)(chunk+n);
-            for(i=1; ;++i)
-            {
-                current_obj = next_obj;
-                next_obj = (obj*)((char*)next_obj+n);
-                if(nobjs-1 == i)
-                {
-                    current_obj->free_list_link = nullptr;
-                    break;
-                }
-                else current_obj->free_list_link = next_obj;
-                
-                #ifdef DEBUG
-                cout << current_obj << " " << next_obj<< endl;
-                #endif
-            }
-            return result;
+            __pool_ops::link_blocks(free_list[FREELIST_INDEX(n)], chunk+n, n, nobjs-1);
+            return chunk;
         }
 
     };
@@ -226,8 +670,20 @@ namespace ltx
     char* default_alloc::start_free = 0;
     char* default_alloc::end_free = 0;
     size_t default_alloc::heap_size = 0;
+    default_alloc::chunk_header* default_alloc::chunks = 0;
+    size_t default_alloc::chunk_count = 0;
+    default_alloc::chunk_info* default_alloc::trim_scratch = 0;
+    size_t default_alloc::trim_capacity = 0;
+    size_t default_alloc::trim_interval = 0;
+    size_t default_alloc::frees_since_trim = 0;
+    int default_alloc::refill_batch[__NFREELISTS] = {0};
+    size_t default_alloc::last_refill[__NFREELISTS] = {0};
+    size_t default_alloc::refill_clock = 0;
 
     default_alloc::obj* volatile default_alloc::free_list[__NFREELISTS] = {0};
+#ifdef LTX_ALLOC_STATS
+    default_alloc::stat_counters default_alloc::counters = default_alloc::stat_counters();
+#endif
 
 }
 
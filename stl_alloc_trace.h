@@ -0,0 +1,248 @@
+#ifndef STL_ALLOC_TRACE_H
+#define STL_ALLOC_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+namespace ltx
+{
+    // 配置记录
+    // 定义LTX_ALLOC_TRACE后, base_alloc和default_alloc的每次配置/释放都记录为一条alloc_trace_record,
+    // 先写入本线程的缓冲区(不加锁), 缓冲区满了或线程退出时加锁整块写入文件
+    // 文件名取环境变量LTX_ALLOC_TRACE_FILE, 默认为alloc_trace.bin, 也可以用alloc_trace::open指定
+    // 记录文件可以用load_trace读入, 再用replay_trace在任意配置器上重放
+
+    enum {__TRACE_ALLOC = 0, __TRACE_FREE = 1};
+
+    struct alloc_trace_record
+    {
+        std::uint64_t time;     // 距离开始记录的纳秒数
+        std::uint64_t addr;     // 区块地址
+        std::uint64_t size;     // 请求的字节数
+        std::uint16_t thread;   // 线程编号
+        std::uint8_t op;        // __TRACE_ALLOC或__TRACE_FREE
+        std::uint8_t pad[5];    // 补齐到32字节, 写入文件的字节都有确定的值
+    };
+
+    class alloc_trace
+    {
+    private:
+        enum {__BUFFER_RECORDS = 4096};
+
+        // 输出文件, 所有线程共享
+        struct sink
+        {
+            std::mutex lock;
+            std::FILE * file;
+            bool opened;        // 打开过文件(包括失败), 不再自动打开默认文件
+            std::atomic<bool> on;
+            std::atomic<std::uint16_t> threads;
+            std::chrono::steady_clock::time_point start;
+
+            sink() : file(nullptr), opened(false), on(true), threads(0),
+                start(std::chrono::steady_clock::now()) {}
+        };
+
+        // 线程缓冲区, 线程退出时写出剩余的记录
+        struct buffer
+        {
+            alloc_trace_record records[__BUFFER_RECORDS];
+            size_t count;
+            std::uint16_t thread;
+
+            buffer() : count(0), thread(output().threads.fetch_add(1)) {}
+            ~buffer()
+            {
+                write_out(*this);
+                destroyed() = true;
+            }
+        };
+
+        // 永不析构, 其他线程退出时还可能写出缓冲区
+        static sink & output()
+        {
+            static sink * s = new sink();
+            return *s;
+        }
+
+        // 缓冲区已经析构, 平凡析构的thread_local在线程退出的整个过程中都可以读取
+        static bool & destroyed()
+        {
+            static thread_local bool d = false;
+            return d;
+        }
+
+        // 线程退出时缓冲区析构之后的配置/释放(如其他thread_local的析构函数中)返回nullptr, 不再记录
+        static buffer * local()
+        {
+            if(destroyed()) return nullptr;
+            static thread_local buffer b;
+            return &b;
+        }
+
+    public:
+        static void record(int op, void * p, size_t n)
+        {
+            sink & s = output();
+            if(!s.on.load(std::memory_order_relaxed)) return ;
+            buffer * pb = local();
+            if(pb == nullptr) return ;
+            buffer & b = *pb;
+            alloc_trace_record & r = b.records[b.count];
+            r.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - s.start).count();
+            r.addr = (std::uint64_t)(std::uintptr_t)p;
+            r.size = (std::uint64_t)n;
+            r.thread = b.thread;
+            r.op = (std::uint8_t)op;
+            std::memset(r.pad, 0, sizeof(r.pad));
+            if(++b.count == (size_t)__BUFFER_RECORDS) write_out(b);
+        }
+
+        // 改为记录到path, 之前的文件被关闭
+        static bool open(const char * path)
+        {
+            sink & s = output();
+            std::lock_guard<std::mutex> guard(s.lock);
+            if(s.file != nullptr) std::fclose(s.file);
+            s.file = std::fopen(path, "wb");
+            s.opened = true;
+            s.on.store(s.file != nullptr);
+            return s.file != nullptr;
+        }
+
+        // 写出本线程缓冲区中的记录
+        static void flush()
+        {
+            buffer * b = local();
+            if(b != nullptr) write_out(*b);
+        }
+
+        // 写出本线程的记录并关闭文件, 之后的配置不再记录
+        // 其他线程应在此之前退出或调用flush
+        static void stop()
+        {
+            sink & s = output();
+            flush();
+            s.on.store(false);
+            std::lock_guard<std::mutex> guard(s.lock);
+            if(s.file != nullptr) std::fclose(s.file);
+            s.file = nullptr;
+        }
+
+    private:
+        static void write_out(buffer & b)
+        {
+            if(b.count == 0) return ;
+            sink & s = output();
+            std::lock_guard<std::mutex> guard(s.lock);
+            if(s.file == nullptr && !s.opened)
+            {
+                const char * path = std::getenv("LTX_ALLOC_TRACE_FILE");
+                s.file = std::fopen(path != nullptr ? path : "alloc_trace.bin", "wb");
+                s.opened = true;
+            }
+            if(s.file != nullptr)
+                std::fwrite(b.records, sizeof(alloc_trace_record), b.count, s.file);
+            b.count = 0;
+        }
+    };
+
+    // 重放用的操作, 区块地址换成了连续的槽号
+    struct replay_op
+    {
+        std::uint64_t size;
+        std::uint32_t slot;
+        std::uint8_t op;
+    };
+
+    // 读入记录文件, 按时间排序, 把地址换成槽号(释放后的槽号会被复用)
+    // 释放开始记录之前配置的区块的记录被丢弃; nslots为需要的槽数
+    inline bool load_trace(const char * path, std::vector<replay_op> & ops, size_t & nslots)
+    {
+        std::FILE * f = std::fopen(path, "rb");
+        if(f == nullptr) return false;
+        std::vector<alloc_trace_record> records;
+        alloc_trace_record r;
+        while(std::fread(&r, sizeof(r), 1, f) == 1) records.push_back(r);
+        std::fclose(f);
+
+        // 不同线程的记录按块写出, 先恢复时间顺序
+        std::stable_sort(records.begin(), records.end(),
+            [](const alloc_trace_record & a, const alloc_trace_record & b) { return a.time < b.time; });
+
+        std::unordered_map<std::uint64_t, std::uint32_t> live;
+        std::vector<std::uint32_t> free_slots;
+        ops.clear();
+        nslots = 0;
+        for(size_t i=0; i<records.size(); ++i)
+        {
+            const alloc_trace_record & rec = records[i];
+            replay_op op;
+            op.size = rec.size;
+            op.op = rec.op;
+            if(rec.op == __TRACE_ALLOC)
+            {
+                if(!free_slots.empty())
+                {
+                    op.slot = free_slots.back();
+                    free_slots.pop_back();
+                }
+                else op.slot = (std::uint32_t)nslots++;
+                live[rec.addr] = op.slot;
+            }
+            else
+            {
+                std::unordered_map<std::uint64_t, std::uint32_t>::iterator it = live.find(rec.addr);
+                if(it == live.end()) continue;
+                op.slot = it->second;
+                free_slots.push_back(op.slot);
+                live.erase(it);
+            }
+            ops.push_back(op);
+        }
+        return true;
+    }
+
+    // 在配置器Alloc上重放ops, 返回耗时(纳秒)
+    // 每个区块配置后写入首字节, 结束时仍未释放的区块在计时之后释放
+    template <typename Alloc>
+    double replay_trace(const std::vector<replay_op> & ops, size_t nslots)
+    {
+        std::vector<void*> slots(nslots, nullptr);
+        std::vector<std::uint64_t> sizes(nslots, 0);
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for(size_t i=0; i<ops.size(); ++i)
+        {
+            const replay_op & op = ops[i];
+            if(op.op == __TRACE_ALLOC)
+            {
+                char * p = (char*) Alloc::allocate((size_t)op.size);
+                if(op.size != 0) *p = 0;
+                slots[op.slot] = p;
+                sizes[op.slot] = op.size;
+            }
+            else
+            {
+                Alloc::deallocate(slots[op.slot], (size_t)sizes[op.slot]);
+                slots[op.slot] = nullptr;
+            }
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        for(size_t i=0; i<nslots; ++i)
+            if(slots[i] != nullptr) Alloc::deallocate(slots[i], (size_t)sizes[i]);
+        return std::chrono::duration<double, std::nano>(end - begin).count();
+    }
+
+}
+
+#endif
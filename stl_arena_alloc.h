@@ -0,0 +1,137 @@
+#ifndef STL_ARENA_ALLOC_H
+#define STL_ARENA_ALLOC_H
+
+#include <cstddef>
+#include <new>
+
+namespace ltx
+{
+    // 单调(arena)配置器
+    // 从大块中顺序切分空间, deallocate什么也不做, 由reset()或release()一次性回收
+    // inst用来区分不同的arena, 例如每类请求使用一个arena_alloc<n>
+    // 必须在使用它的容器全部析构后才能reset()/release()
+    template <int inst = 0>
+    class arena_alloc
+    {
+    private:
+        enum {__ARENA_ALIGN = alignof(std::max_align_t)};
+        enum {__MIN_BLOCK = 4*1024};        // 第一个大块的大小
+        enum {__MAX_BLOCK = 1024*1024};     // 大块大小翻倍的上限
+
+        static size_t ROUND_UP(size_t bytes)
+        {
+            return ( (bytes+__ARENA_ALIGN-1) & (~(size_t)(__ARENA_ALIGN-1)) );
+        }
+
+        // 大块头部, 所有大块串成链表, 最新的在表头
+        struct block_header
+        {
+            block_header * next;
+            size_t size;        // 头部之后可切分的字节数
+            char * data() { return (char*)this + ROUND_UP(sizeof(block_header)); }
+        };
+
+        static block_header * blocks;
+        static char * cur;
+        static char * end;
+        static size_t next_block_size;
+        static size_t used;
+
+    public:
+        static void * allocate(size_t n)
+        {
+            n = ROUND_UP(n);
+            used += n;
+            if(size_t(end - cur) >= n)
+            {
+                char * result = cur;
+                cur += n;
+                return result;
+            }
+            return allocate_block(n);
+        }
+
+        static void deallocate(void *, size_t) {}
+
+        // 保留最新(也是最大)的大块, 释放其余大块, 从头开始切分
+        static void reset()
+        {
+            if(blocks == nullptr) return ;
+            free_blocks(blocks->next);
+            blocks->next = nullptr;
+            cur = blocks->data();
+            end = cur + blocks->size;
+            used = 0;
+        }
+
+        // 释放所有大块
+        static void release()
+        {
+            free_blocks(blocks);
+            blocks = nullptr;
+            cur = end = nullptr;
+            next_block_size = __MIN_BLOCK;
+            used = 0;
+        }
+
+        // 自上次reset/release以来配置出去的字节数
+        static size_t bytes_used() { return used; }
+
+    private:
+        static void * allocate_block(size_t n)
+        {
+            // 大请求单独使用一个大块, 挂在当前块之后, 当前块继续切分
+            if(n > next_block_size/2)
+            {
+                block_header * b = new_block(n);
+                if(blocks != nullptr)
+                {
+                    b->next = blocks->next;
+                    blocks->next = b;
+                }
+                else blocks = b;
+                return b->data();
+            }
+
+            block_header * b = new_block(next_block_size);
+            b->next = blocks;
+            blocks = b;
+            if(next_block_size < __MAX_BLOCK) next_block_size *= 2;
+            cur = b->data() + n;
+            end = b->data() + b->size;
+            return b->data();
+        }
+
+        static block_header * new_block(size_t size)
+        {
+            block_header * b = (block_header*) ::operator new(ROUND_UP(sizeof(block_header)) + size);
+            b->next = nullptr;
+            b->size = size;
+            return b;
+        }
+
+        static void free_blocks(block_header * b)
+        {
+            while(b != nullptr)
+            {
+                block_header * next = b->next;
+                ::operator delete(b);
+                b = next;
+            }
+        }
+    };
+    // 定义和初始化类中的静态变量
+    template <int inst>
+    typename arena_alloc<inst>::block_header * arena_alloc<inst>::blocks = nullptr;
+    template <int inst>
+    char * arena_alloc<inst>::cur = nullptr;
+    template <int inst>
+    char * arena_alloc<inst>::end = nullptr;
+    template <int inst>
+    size_t arena_alloc<inst>::next_block_size = arena_alloc<inst>::__MIN_BLOCK;
+    template <int inst>
+    size_t arena_alloc<inst>::used = 0;
+
+}
+
+#endif
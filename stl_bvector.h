@@ -0,0 +1,456 @@
+#ifndef STL_BVECTOR_H
+#define STL_BVECTOR_H
+
+// 本文件由vector.h包含, 不要直接使用
+
+#include <cstddef>
+#include <cstring>
+
+namespace ltx
+{
+    // vector<bool>的位压缩实现, 参照SGI的stl_bvector.h
+    // 以字为单位存放, 每个元素占一位; 通过代理__bit_reference读写单个位
+    // 最后一个字中超出size()的位是未定义的, 所有按字进行的操作都会忽略它们
+
+    typedef unsigned long __bit_word;
+    enum {__WORD_BIT = int(8*sizeof(__bit_word))};
+
+    inline int __bit_popcount(__bit_word w)
+    {
+#if defined(__GNUC__)
+        return __builtin_popcountl(w);
+#else
+        int n = 0;
+        for(; w != 0; w &= w-1) ++n;
+        return n;
+#endif
+    }
+
+    // w不为0, 返回最低的1所在的位置
+    inline int __bit_ctz(__bit_word w)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctzl(w);
+#else
+        int n = 0;
+        for(; (w & 1) == 0; w >>= 1) ++n;
+        return n;
+#endif
+    }
+
+    // 单个位的代理引用
+    struct __bit_reference
+    {
+        __bit_word * p;
+        __bit_word mask;
+
+        __bit_reference(__bit_word * x, __bit_word y) : p(x), mask(y) {}
+        __bit_reference() : p(0), mask(0) {}
+
+        operator bool() const { return (*p & mask) != 0; }
+        __bit_reference& operator=(bool x)
+        {
+            if(x) *p |= mask;
+            else *p &= ~mask;
+            return *this;
+        }
+        __bit_reference& operator=(const __bit_reference& x) { return *this = bool(x); }
+        bool operator==(const __bit_reference& x) const { return bool(*this) == bool(x); }
+        bool operator<(const __bit_reference& x) const { return !bool(*this) && bool(x); }
+        void flip() { *p ^= mask; }
+    };
+
+    inline void swap(__bit_reference x, __bit_reference y)
+    {
+        bool tmp = x;
+        x = y;
+        y = tmp;
+    }
+
+    // 位迭代器: 所在的字和字内的偏移
+    struct __bit_iterator_base
+    {
+        typedef random_access_iterator_tag iterator_category;
+        typedef bool value_type;
+        typedef ptrdiff_t difference_type;
+
+        __bit_word * p;
+        unsigned int offset;
+
+        __bit_iterator_base(__bit_word * x, unsigned int y) : p(x), offset(y) {}
+
+        void bump_up()
+        {
+            if(offset++ == __WORD_BIT - 1)
+            {
+                offset = 0;
+                ++p;
+            }
+        }
+        void bump_down()
+        {
+            if(offset-- == 0)
+            {
+                offset = __WORD_BIT - 1;
+                --p;
+            }
+        }
+        void incr(difference_type i)
+        {
+            difference_type n = i + offset;
+            p += n / __WORD_BIT;
+            n = n % __WORD_BIT;
+            if(n < 0)
+            {
+                offset = (unsigned int) n + __WORD_BIT;
+                --p;
+            }
+            else offset = (unsigned int) n;
+        }
+
+        bool operator==(const __bit_iterator_base& x) const { return p == x.p && offset == x.offset; }
+        bool operator!=(const __bit_iterator_base& x) const { return !(*this == x); }
+        bool operator<(const __bit_iterator_base& x) const
+        {
+            return p < x.p || (p == x.p && offset < x.offset);
+        }
+        bool operator>(const __bit_iterator_base& x) const { return x < *this; }
+        bool operator<=(const __bit_iterator_base& x) const { return !(x < *this); }
+        bool operator>=(const __bit_iterator_base& x) const { return !(*this < x); }
+
+        difference_type operator-(const __bit_iterator_base& x) const
+        {
+            return difference_type(__WORD_BIT) * (p - x.p) + offset - x.offset;
+        }
+    };
+
+    struct __bit_iterator : public __bit_iterator_base
+    {
+        typedef __bit_reference reference;
+        typedef __bit_reference* pointer;
+        typedef __bit_iterator self;
+
+        __bit_iterator() : __bit_iterator_base(0, 0) {}
+        __bit_iterator(__bit_word * x, unsigned int y) : __bit_iterator_base(x, y) {}
+
+        reference operator*() const { return reference(p, __bit_word(1) << offset); }
+        reference operator[](difference_type i) const { return *(*this + i); }
+
+        self& operator++() { bump_up(); return *this; }
+        self operator++(int) { self tmp = *this; bump_up(); return tmp; }
+        self& operator--() { bump_down(); return *this; }
+        self operator--(int) { self tmp = *this; bump_down(); return tmp; }
+        self& operator+=(difference_type i) { incr(i); return *this; }
+        self& operator-=(difference_type i) { incr(-i); return *this; }
+        self operator+(difference_type i) const { self tmp = *this; return tmp += i; }
+        self operator-(difference_type i) const { self tmp = *this; return tmp -= i; }
+        using __bit_iterator_base::operator-;
+    };
+
+    struct __bit_const_iterator : public __bit_iterator_base
+    {
+        typedef bool reference;
+        typedef bool const_reference;
+        typedef const bool* pointer;
+        typedef __bit_const_iterator self;
+
+        __bit_const_iterator() : __bit_iterator_base(0, 0) {}
+        __bit_const_iterator(__bit_word * x, unsigned int y) : __bit_iterator_base(x, y) {}
+        __bit_const_iterator(const __bit_iterator& x) : __bit_iterator_base(x.p, x.offset) {}
+
+        reference operator*() const { return (*p & (__bit_word(1) << offset)) != 0; }
+        reference operator[](difference_type i) const { return *(*this + i); }
+
+        self& operator++() { bump_up(); return *this; }
+        self operator++(int) { self tmp = *this; bump_up(); return tmp; }
+        self& operator--() { bump_down(); return *this; }
+        self operator--(int) { self tmp = *this; bump_down(); return tmp; }
+        self& operator+=(difference_type i) { incr(i); return *this; }
+        self& operator-=(difference_type i) { incr(-i); return *this; }
+        self operator+(difference_type i) const { self tmp = *this; return tmp += i; }
+        self operator-(difference_type i) const { self tmp = *this; return tmp -= i; }
+        using __bit_iterator_base::operator-;
+    };
+
+    template <typename Alloc, typename Grow>
+    class vector<bool, Alloc, Grow> : protected alloc_holder<Alloc>
+    {
+    public:
+        typedef bool                    value_type;
+        typedef size_t                  size_type;
+        typedef ptrdiff_t               difference_type;
+        typedef __bit_reference         reference;
+        typedef bool                    const_reference;
+        typedef __bit_reference*        pointer;
+        typedef const bool*             const_pointer;
+        typedef __bit_iterator          iterator;
+        typedef __bit_const_iterator    const_iterator;
+
+    protected:
+        typedef simple_alloc<__bit_word, Alloc> data_allocator;
+        typedef alloc_holder<Alloc> alloc_base;
+        using alloc_base::get_alloc;
+
+        // start的偏移总是0
+        iterator start;
+        iterator finish;
+        __bit_word * end_of_storage;
+
+        // 容纳n个位需要的字数
+        static size_type words(size_type n) { return (n + __WORD_BIT - 1) / __WORD_BIT; }
+
+        // 最后一个字中有效位的掩码, n为总位数
+        static __bit_word tail_mask(size_type n)
+        {
+            unsigned int rem = n % __WORD_BIT;
+            return rem == 0 ? ~__bit_word(0) : (__bit_word(1) << rem) - 1;
+        }
+
+        void initialize(size_type n)
+        {
+            __bit_word * q = data_allocator::allocate(get_alloc(), words(n));
+            end_of_storage = q + words(n);
+            start = iterator(q, 0);
+            finish = start + difference_type(n);
+        }
+
+        void deallocate()
+        {
+            if(start.p != nullptr)
+                data_allocator::deallocate(get_alloc(), start.p, end_of_storage - start.p);
+        }
+
+        // 重新配置为nwords个字, 原有的位按字复制
+        void reallocate(size_type nwords)
+        {
+            const size_type n = size();
+            __bit_word * q = data_allocator::allocate(get_alloc(), nwords);
+            if(n != 0) memcpy(q, start.p, words(n)*sizeof(__bit_word));
+            deallocate();
+            start = iterator(q, 0);
+            finish = start + difference_type(n);
+            end_of_storage = q + nwords;
+        }
+
+        // 保证还能再放n个位, 新容量由增长策略决定
+        void grow_for(size_type n)
+        {
+            if(capacity() - size() < n)
+                reallocate(Grow::next_capacity(end_of_storage - start.p, words(size()+n), sizeof(__bit_word)));
+        }
+
+        static iterator copy_bits(iterator first, iterator last, iterator result)
+        {
+            for(; first != last; ++first, ++result) *result = bool(*first);
+            return result;
+        }
+        static iterator copy_bits_backward(iterator first, iterator last, iterator result)
+        {
+            while(first != last) *--result = bool(*--last);
+            return result;
+        }
+        static void fill_bits(iterator first, iterator last, bool x)
+        {
+            for(; first != last; ++first) *first = x;
+        }
+
+    public:
+        iterator begin() { return start; }
+        iterator end() { return finish; }
+        const_iterator begin() const { return start; }
+        const_iterator end() const { return finish; }
+
+        size_type size() const { return size_type(finish - start); }
+        size_type capacity() const { return size_type(end_of_storage - start.p) * __WORD_BIT; }
+        bool empty() const { return start == finish; }
+
+        reference operator[](size_type n) { return *(begin() + difference_type(n)); }
+        const_reference operator[](size_type n) const { return *(begin() + difference_type(n)); }
+        reference front() { return *begin(); }
+        reference back() { return *(end() - 1); }
+        const_reference front() const { return *begin(); }
+        const_reference back() const { return *(end() - 1); }
+
+        vector() : start(), finish(), end_of_storage(nullptr) {}
+        explicit vector(const Alloc& a) : alloc_base(a), start(), finish(), end_of_storage(nullptr) {}
+        vector(size_type n, bool value, const Alloc& a = Alloc()) : alloc_base(a)
+        {
+            initialize(n);
+            if(n != 0) memset(start.p, value ? 0xff : 0, words(n)*sizeof(__bit_word));
+        }
+        explicit vector(size_type n, const Alloc& a = Alloc()) : alloc_base(a)
+        {
+            initialize(n);
+            if(n != 0) memset(start.p, 0, words(n)*sizeof(__bit_word));
+        }
+
+        vector(const vector& x) : alloc_base(x.get_alloc())
+        {
+            initialize(x.size());
+            if(x.size() != 0) memcpy(start.p, x.start.p, words(x.size())*sizeof(__bit_word));
+        }
+
+        vector(vector&& x) noexcept
+            : alloc_base(x.get_alloc()), start(x.start), finish(x.finish), end_of_storage(x.end_of_storage)
+        {
+            x.start = x.finish = iterator();
+            x.end_of_storage = nullptr;
+        }
+
+        ~vector() { deallocate(); }
+
+        vector& operator=(const vector& x)
+        {
+            if(&x == this) return *this;
+            if(!this->same_alloc(x) || x.size() > capacity())
+            {
+                deallocate();
+                start = finish = iterator();
+                end_of_storage = nullptr;
+                get_alloc() = x.get_alloc();
+                initialize(x.size());
+            }
+            else finish = start + difference_type(x.size());
+            if(x.size() != 0) memcpy(start.p, x.start.p, words(x.size())*sizeof(__bit_word));
+            return *this;
+        }
+
+        vector& operator=(vector&& x) noexcept
+        {
+            if(&x == this) return *this;
+            deallocate();
+            get_alloc() = x.get_alloc();
+            start = x.start;
+            finish = x.finish;
+            end_of_storage = x.end_of_storage;
+            x.start = x.finish = iterator();
+            x.end_of_storage = nullptr;
+            return *this;
+        }
+
+        void swap(vector& x) noexcept
+        {
+            std::swap(start, x.start);
+            std::swap(finish, x.finish);
+            std::swap(end_of_storage, x.end_of_storage);
+            this->swap_alloc(x);
+        }
+
+        Alloc get_allocator() const { return get_alloc(); }
+
+        void reserve(size_type n)
+        {
+            if(n > capacity()) reallocate(words(n));
+        }
+
+        void push_back(bool x)
+        {
+            if(finish.p == end_of_storage) grow_for(1);
+            *finish = x;
+            ++finish;
+        }
+        void pop_back() { --finish; }
+
+        iterator insert(iterator position, bool x)
+        {
+            const difference_type n = position - start;
+            insert(position, 1, x);
+            return start + n;
+        }
+
+        void insert(iterator position, size_type n, bool x)
+        {
+            if(n == 0) return ;
+            const difference_type elems_before = position - start;
+            grow_for(n);
+            position = start + elems_before;
+            copy_bits_backward(position, finish, finish + difference_type(n));
+            fill_bits(position, position + difference_type(n), x);
+            finish += difference_type(n);
+        }
+
+        iterator erase(iterator position)
+        {
+            copy_bits(position + 1, finish, position);
+            --finish;
+            return position;
+        }
+        iterator erase(iterator first, iterator last)
+        {
+            finish = copy_bits(last, finish, first);
+            return first;
+        }
+
+        void resize(size_type new_size, bool x = false)
+        {
+            if(new_size < size()) erase(begin() + difference_type(new_size), end());
+            else insert(end(), new_size - size(), x);
+        }
+        void clear() { finish = start; }
+
+        // 以下操作按字进行
+
+        // 翻转所有位
+        void flip()
+        {
+            for(__bit_word * p = start.p; p < start.p + words(size()); ++p) *p = ~*p;
+        }
+
+        // 为1的位的个数
+        size_type count() const
+        {
+            const size_type n = size();
+            if(n == 0) return 0;
+            const size_type nwords = words(n);
+            size_type result = 0;
+            for(size_type i=0; i+1<nwords; ++i) result += __bit_popcount(start.p[i]);
+            return result + __bit_popcount(start.p[nwords-1] & tail_mask(n));
+        }
+
+        // 第一个为1的位的下标, 没有时返回size()
+        size_type find_first() const { return find_from(0); }
+
+        // pos之后第一个为1的位的下标, 没有时返回size()
+        size_type find_next(size_type pos) const { return find_from(pos + 1); }
+
+        // 按位与, x较短时缺少的位视为0
+        vector& operator&=(const vector& x)
+        {
+            const size_type n = x.size() < size() ? x.size() : size();
+            for(size_type i=0; i<words(n); ++i) start.p[i] &= x.start.p[i];
+            fill_bits(begin() + difference_type(n), end(), false);
+            return *this;
+        }
+
+        // 按位或, x较长时多出的位被忽略
+        vector& operator|=(const vector& x)
+        {
+            const size_type n = x.size() < size() ? x.size() : size();
+            if(n == 0) return *this;
+            const size_type nwords = words(n);
+            for(size_type i=0; i+1<nwords; ++i) start.p[i] |= x.start.p[i];
+            start.p[nwords-1] |= x.start.p[nwords-1] & tail_mask(n);
+            return *this;
+        }
+
+    protected:
+        size_type find_from(size_type pos) const
+        {
+            const size_type n = size();
+            if(pos >= n) return n;
+            size_type i = pos / __WORD_BIT;
+            __bit_word w = start.p[i] & (~__bit_word(0) << (pos % __WORD_BIT));
+            const size_type nwords = words(n);
+            while(w == 0)
+            {
+                if(++i == nwords) return n;
+                w = start.p[i];
+            }
+            size_type result = i*__WORD_BIT + __bit_ctz(w);
+            return result < n ? result : n;
+        }
+    };
+
+}
+
+#endif
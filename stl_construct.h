@@ -2,16 +2,18 @@
 #define STL_CONSTRUCT_H
 
 #include <type_traits>
+#include <utility>
 #include <iostream>
 using namespace std;
 
 // 定义全局函数, 用于对象的构造和析构
 namespace ltx
 {
-    template <typename T1, typename T2>
-    inline void _construct(T1* p, const T2& value)
+    // 以args为参数在p处构造对象, 参数完美转发给构造函数
+    template <typename T1, typename... Args>
+    inline void _construct(T1* p, Args&&... args)
     {
-        new (p) T1(value);
+        new (p) T1(std::forward<Args>(args)...);
     }
 
     template <typename T>
@@ -24,7 +26,8 @@ namespace ltx
     template <typename ForwardIterator>
     inline void _destroy(ForwardIterator first, ForwardIterator last)
     {
-        bool is_trivial = std::is_trivially_destructible<decltype(*first)>::value;
+        bool is_trivial = std::is_trivially_destructible<
+            typename std::remove_reference<decltype(*first)>::type>::value;
         if(is_trivial) {}
         else 
         {
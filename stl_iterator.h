@@ -2,6 +2,8 @@
 #define STL_ITERATOR_H
 #include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <type_traits>
 namespace ltx
 {
     struct input_iterator_tag {};
@@ -131,6 +133,54 @@ namespace ltx
     }
 
 
+    // 分段迭代器
+    // 由若干段连续空间组成的迭代器(例如deque的迭代器)特化此模板, 提供:
+    //   segment_iterator  遍历各段的迭代器
+    //   local_iterator    段内的迭代器(指针)
+    //   segment(it), local(it)  it所在的段和段内位置
+    //   begin(s), end(s)        段s的首尾
+    //   compose(s, l)           由段和段内位置还原迭代器, l为段尾时得到下一段的开头
+    // 算法据此把区间拆成若干段连续空间, 每段用指针处理
+    template <typename Iterator>
+    struct segmented_iterator_traits
+    {
+        static const bool is_segmented = false;
+    };
+
+    // 按迭代器分类选择实现时使用, ltx和标准库的分类标签都能识别
+    template <typename Iterator, typename Tag, typename StdTag>
+    struct __iterator_category_is
+        : std::integral_constant<bool,
+            std::is_base_of<Tag, typename iterator_traits<Iterator>::iterator_category>::value
+            || std::is_base_of<StdTag, typename iterator_traits<Iterator>::iterator_category>::value> {};
+
+    template <typename Iterator>
+    struct __is_forward_iterator
+        : __iterator_category_is<Iterator, forward_iterator_tag, std::forward_iterator_tag> {};
+
+    template <typename Iterator>
+    struct __is_random_access_iterator
+        : __iterator_category_is<Iterator, random_access_iterator_tag, std::random_access_iterator_tag> {};
+
+    // 前向迭代器区间的长度, 随机访问迭代器直接相减, 其他的逐个计数
+    template <typename ForwardIterator>
+    inline size_t __range_length(ForwardIterator first, ForwardIterator last, std::true_type)
+    {
+        return size_t(last - first);
+    }
+    template <typename ForwardIterator>
+    inline size_t __range_length(ForwardIterator first, ForwardIterator last, std::false_type)
+    {
+        size_t n = 0;
+        for(; first != last; ++first) ++n;
+        return n;
+    }
+    template <typename ForwardIterator>
+    inline size_t __range_length(ForwardIterator first, ForwardIterator last)
+    {
+        return __range_length(first, last, __is_random_access_iterator<ForwardIterator>());
+    }
+
     // insert iterator
 
     template <typename Container>
@@ -0,0 +1,271 @@
+#ifndef STL_LOCKFREE_ALLOC_H
+#define STL_LOCKFREE_ALLOC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <new>
+#include "stl_alloc.h"
+
+namespace ltx
+{
+    // 无锁二级配置器
+    // 结构和default_alloc相同, 但free-list表头是带版本号的指针, 用CAS修改
+    // 内存池也用CAS切分, 所以任意线程都可以同时配置或释放, 包括释放别的线程配置的区块
+    // 从内存池拿到的空间永不归还, 所以弹出表头时读取一个已被别的线程取走的区块的next不会访问非法内存,
+    // 而版本号保证这种情况下CAS失败
+    // 支持双字CAS时(x86-64加-mcx16, aarch64)表头是指针和64位版本号两个字;
+    // 否则压缩进一个64位字, 见下面的说明, 定义LTX_LOCKFREE_PACKED_HEAD可以强制使用这种方式
+    class lockfree_alloc
+    {
+    private:
+        static size_t ROUND_UP(size_t bytes)
+        {
+            return ( (bytes+__ALIGN-1) & (~(__ALIGN-1)) );
+        }
+        static size_t FREELIST_INDEX(size_t bytes)
+        {
+            return size_class::index(bytes);
+        }
+
+    private:
+        union obj
+        {
+            union obj * free_list_link;
+            char client_data[1];
+        };
+
+        // 带版本号的指针: 低__PTR_BITS位为地址, 高位为版本号
+        // 双字时地址和版本号各64位, 不会截断, 版本号也不会回绕
+        // 单字时64位平台只留48位地址(4级页表的用户态地址), 剩余16位作为版本号; 32位平台版本号占高32位
+        //   5级页表或52位地址的arm64上地址可能超出48位, 新配置的大块超出时抛出bad_alloc, 而不是悄悄截断
+        //   16位版本号会回绕: 一个线程在读表头和CAS之间恰好错过65536的整数倍次修改才会出现ABA, 极不可能但不是不可能
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16) && !defined(LTX_LOCKFREE_PACKED_HEAD)
+        typedef unsigned __int128 tagged_ptr;
+        enum {__PTR_BITS = 64};
+        typedef tagged_ptr head_type;
+#else
+        typedef std::uint64_t tagged_ptr;
+        enum {__PTR_BITS = sizeof(void*) == 8 ? 48 : 32};
+        typedef std::atomic<tagged_ptr> head_type;
+#endif
+
+        static tagged_ptr make_tagged(obj * p, tagged_ptr tag)
+        {
+            return (tagged_ptr)(std::uintptr_t)p | (tag << __PTR_BITS);
+        }
+        static obj * get_ptr(tagged_ptr t)
+        {
+            return (obj*)(std::uintptr_t)(t & ((tagged_ptr(1) << __PTR_BITS) - 1));
+        }
+        static tagged_ptr get_tag(tagged_ptr t)
+        {
+            return t >> __PTR_BITS;
+        }
+
+        // [p, end)能否放进表头的地址部分
+        static bool addressable(const void * end)
+        {
+            return __PTR_BITS >= 64 || ((std::uint64_t)(std::uintptr_t)end >> (__PTR_BITS & 63)) == 0;
+        }
+
+        // 读取和CAS表头, CAS失败时expected更新为当前值
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16) && !defined(LTX_LOCKFREE_PACKED_HEAD)
+        // 双字分两次读取, 读到撕裂的值也没关系, 随后的CAS会失败并返回正确的值
+        static tagged_ptr load_head(size_t index)
+        {
+            const std::uint64_t * w = (const std::uint64_t*)&free_list[index];
+            std::uint64_t parts[2] = {__atomic_load_n(w, __ATOMIC_ACQUIRE), __atomic_load_n(w+1, __ATOMIC_ACQUIRE)};
+            tagged_ptr t;
+            std::memcpy(&t, parts, sizeof(t));
+            return t;
+        }
+        static bool cas_head(size_t index, tagged_ptr & expected, tagged_ptr desired)
+        {
+            tagged_ptr prev = __sync_val_compare_and_swap(&free_list[index], expected, desired);
+            if(prev == expected) return true;
+            expected = prev;
+            return false;
+        }
+#else
+        static tagged_ptr load_head(size_t index)
+        {
+            return free_list[index].load(std::memory_order_acquire);
+        }
+        static bool cas_head(size_t index, tagged_ptr & expected, tagged_ptr desired)
+        {
+            return free_list[index].compare_exchange_weak(expected, desired,
+                        std::memory_order_acq_rel, std::memory_order_acquire);
+        }
+#endif
+
+        // 内存池中的一大块空间, 头部之后就是可切分的空间
+        struct chunk
+        {
+            std::atomic<size_t> used;
+            size_t size;
+            char * data() { return (char*)(this+1); }
+        };
+
+    private:
+        static head_type free_list[__NFREELISTS];
+        static std::atomic<chunk*> pool;
+        static std::atomic<size_t> heap_size;
+
+    public:
+        static void * allocate(size_t n)
+        {
+            if(n > (size_t)__MAX_BYTES) return base_alloc::allocate(n);
+
+            size_t index = FREELIST_INDEX(n);
+            obj * result = pop(index);
+            if(nullptr == result) return refill(size_class::size(index));
+            return result;
+        }
+
+        static void deallocate(void * p, size_t n)
+        {
+            if(n > (size_t)__MAX_BYTES)
+            {
+                base_alloc::deallocate(p, n);
+                return ;
+            }
+            obj * q = (obj*) p;
+            push(FREELIST_INDEX(n), q, q);
+        }
+
+    private:
+        static obj * pop(size_t index)
+        {
+            tagged_ptr old_head = load_head(index);
+            for(;;)
+            {
+                obj * p = get_ptr(old_head);
+                if(nullptr == p) return nullptr;
+                // p可能已被别的线程取走并正在写入, 这里读到的next可能是任意值
+                // 用原子读取避免撕裂; 那种情况下表头的版本号已经变了, CAS必然失败, 读到的值被丢弃
+                obj * next = __atomic_load_n(&p->free_list_link, __ATOMIC_RELAXED);
+                tagged_ptr new_head = make_tagged(next, get_tag(old_head)+1);
+                if(cas_head(index, old_head, new_head)) return p;
+            }
+        }
+
+        // 把first到last这一串区块放到free-list头部
+        static void push(size_t index, obj * first, obj * last)
+        {
+            tagged_ptr old_head = load_head(index);
+            for(;;)
+            {
+                last->free_list_link = get_ptr(old_head);
+                tagged_ptr new_head = make_tagged(first, get_tag(old_head)+1);
+                if(cas_head(index, old_head, new_head)) return ;
+            }
+        }
+
+        static void * refill(size_t n)
+        {
+            int nobjs = size_class::batch_limit(FREELIST_INDEX(n), 20);
+            char * chunk = chunk_alloc(n, nobjs);
+
+            if(nobjs == 1) return chunk;
+
+            // 除第一个区块外串成一条链, 一次CAS放入free-list
+            obj * first = (obj*)(chunk+n);
+            obj * current_obj = first;
+            for(int i=2; i<nobjs; ++i)
+            {
+                current_obj->free_list_link = (obj*)(chunk + i*n);
+                current_obj = current_obj->free_list_link;
+            }
+            push(FREELIST_INDEX(n), first, current_obj);
+            return chunk;
+        }
+
+        // 把一段不足一个区块的零头按能放下的最大区块切分, 放入相应的free-list
+        static void push_remainder(char * p, size_t bytes)
+        {
+            while(bytes > 0)
+            {
+                size_t index = size_class::index_floor(bytes);
+                push(index, (obj*)p, (obj*)p);
+                p += size_class::size(index);
+                bytes -= size_class::size(index);
+            }
+        }
+
+        // 从当前内存块中用CAS切出最多nobjs个区块, 当前块不够一个区块时换一个新块
+        static char * chunk_alloc(size_t size, int & nobjs)
+        {
+            for(;;)
+            {
+                chunk * c = pool.load(std::memory_order_acquire);
+                if(c != nullptr)
+                {
+                    size_t used = c->used.load(std::memory_order_relaxed);
+                    while(c->size - used >= size)
+                    {
+                        size_t n = (c->size - used) / size;
+                        if(n > (size_t)nobjs) n = nobjs;
+                        if(c->used.compare_exchange_weak(used, used + n*size,
+                                std::memory_order_relaxed))
+                        {
+                            nobjs = n;
+                            return c->data() + used;
+                        }
+                    }
+                    // 剩余的零头放入相应的free-list
+                    used = c->used.exchange(c->size, std::memory_order_relaxed);
+                    if(used < c->size)
+                        push_remainder(c->data() + used, c->size - used);
+                }
+
+                size_t total_bytes = size*nobjs;
+                size_t bytes_to_get = 2*total_bytes +
+                    ROUND_UP(heap_size.load(std::memory_order_relaxed)>>4);
+                chunk * new_chunk;
+                try
+                {
+                    new_chunk = (chunk*) ::operator new(sizeof(chunk) + bytes_to_get);
+                }
+                catch(std::bad_alloc & e)
+                {
+                    // 从更大的free-list中借一个区块, 多出来的部分放回相应的free-list
+                    for(size_t i=FREELIST_INDEX(size)+1; i<(size_t)__NFREELISTS; ++i)
+                    {
+                        obj * p = pop(i);
+                        if(p != nullptr)
+                        {
+                            push_remainder((char*)p + size, size_class::size(i) - size);
+                            nobjs = 1;
+                            return (char*)p;
+                        }
+                    }
+                    throw;
+                }
+                if(!addressable(new_chunk->data() + bytes_to_get))
+                {
+                    ::operator delete(new_chunk);
+                    throw std::bad_alloc();
+                }
+                new_chunk->size = bytes_to_get;
+                new_chunk->used.store(total_bytes, std::memory_order_relaxed);
+                // 别的线程已经换上了新块, 丢弃自己的块重新切分
+                if(!pool.compare_exchange_strong(c, new_chunk, std::memory_order_acq_rel))
+                {
+                    ::operator delete(new_chunk);
+                    continue;
+                }
+                heap_size.fetch_add(bytes_to_get, std::memory_order_relaxed);
+                return new_chunk->data();
+            }
+        }
+    };
+    // 定义和初始化类中的静态变量
+    lockfree_alloc::head_type lockfree_alloc::free_list[__NFREELISTS];
+    std::atomic<lockfree_alloc::chunk*> lockfree_alloc::pool(nullptr);
+    std::atomic<size_t> lockfree_alloc::heap_size(0);
+
+}
+
+#endif
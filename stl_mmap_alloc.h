@@ -0,0 +1,141 @@
+#ifndef STL_MMAP_ALLOC_H
+#define STL_MMAP_ALLOC_H
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include "stl_alloc.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ltx
+{
+    // 大块配置器
+    // 不小于Threshold字节的请求直接用mmap映射, 其余请求仍交给default_alloc
+    // HugePage为true时, 2MB以上的映射按2MB对齐并用madvise(MADV_HUGEPAGE)请求透明大页
+    // 非Linux平台没有mmap, 大块请求退化为base_alloc
+    template <size_t Threshold = 2*1024*1024, bool HugePage = true>
+    class mmap_alloc
+    {
+    private:
+        enum {__HUGE_PAGE_SIZE = 2*1024*1024};
+
+        static size_t page_size()
+        {
+#if defined(__linux__)
+            static const size_t sz = (size_t) sysconf(_SC_PAGESIZE);
+            return sz;
+#else
+            return 4096;
+#endif
+        }
+        // 将bytes上调至页大小的倍数
+        static size_t ROUND_UP_PAGE(size_t bytes)
+        {
+            return (bytes + page_size() - 1) & ~(page_size() - 1);
+        }
+        static bool use_huge_page(size_t bytes)
+        {
+            return HugePage && bytes >= (size_t)__HUGE_PAGE_SIZE;
+        }
+
+    public:
+        static void * allocate(size_t n)
+        {
+            if(n < Threshold) return default_alloc::allocate(n);
+            return map_pages(n);
+        }
+
+        static void deallocate(void * p, size_t n)
+        {
+            if(n < Threshold)
+            {
+                default_alloc::deallocate(p, n);
+                return ;
+            }
+            unmap_pages(p, n);
+        }
+
+        // 把p处old_sz字节的空间调整为new_sz字节, 内容保持不变
+        // 新旧大小都在mmap路径上时用mremap, 能原地扩展就原地扩展, 否则由内核搬移页表而不复制数据
+        static void * reallocate(void * p, size_t old_sz, size_t new_sz)
+        {
+#if defined(__linux__)
+            if(old_sz >= Threshold && new_sz >= Threshold)
+            {
+                size_t old_len = ROUND_UP_PAGE(old_sz);
+                size_t new_len = ROUND_UP_PAGE(new_sz);
+                if(old_len == new_len) return p;
+                // 先尝试原地调整
+                void * result = mremap(p, old_len, new_len, 0);
+                if(result == MAP_FAILED)
+                {
+                    if(use_huge_page(new_len))
+                    {
+                        // 先映射一段按大页对齐的空间, 再把原有的页移到那里, 使新空间仍能使用大页
+                        void * target = map_pages(new_sz);
+                        result = mremap(p, old_len, new_len, MREMAP_MAYMOVE|MREMAP_FIXED, target);
+                        if(result == MAP_FAILED)
+                        {
+                            munmap(target, new_len);
+                            throw std::bad_alloc();
+                        }
+                    }
+                    else
+                    {
+                        result = mremap(p, old_len, new_len, MREMAP_MAYMOVE);
+                        if(result == MAP_FAILED) throw std::bad_alloc();
+                    }
+                }
+                if(use_huge_page(new_len)) madvise(result, new_len, MADV_HUGEPAGE);
+                return result;
+            }
+#endif
+            void * result = allocate(new_sz);
+            memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
+            deallocate(p, old_sz);
+            return result;
+        }
+
+    private:
+        static void * map_pages(size_t n)
+        {
+#if defined(__linux__)
+            size_t len = ROUND_UP_PAGE(n);
+            if(!use_huge_page(len))
+            {
+                void * p = mmap(0, len, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+                if(p == MAP_FAILED) throw std::bad_alloc();
+                return p;
+            }
+            // 多映射一个大页, 再把首尾不对齐的部分解除映射, 使起始地址按大页对齐
+            size_t map_len = len + __HUGE_PAGE_SIZE;
+            char * raw = (char*) mmap(0, map_len, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+            if(raw == (char*)MAP_FAILED) throw std::bad_alloc();
+            char * aligned = (char*)(((size_t)raw + __HUGE_PAGE_SIZE - 1) & ~(size_t)(__HUGE_PAGE_SIZE - 1));
+            if(aligned != raw) munmap(raw, aligned - raw);
+            size_t tail = (raw + map_len) - (aligned + len);
+            if(tail != 0) munmap(aligned + len, tail);
+            madvise(aligned, len, MADV_HUGEPAGE);
+            return aligned;
+#else
+            return base_alloc::allocate(n);
+#endif
+        }
+
+        static void unmap_pages(void * p, size_t n)
+        {
+#if defined(__linux__)
+            munmap(p, ROUND_UP_PAGE(n));
+#else
+            base_alloc::deallocate(p, n);
+#endif
+        }
+    };
+
+}
+
+#endif
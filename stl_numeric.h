@@ -1,6 +1,8 @@
 #ifndef STL_NUMERIC_H
 #define STL_NUMERIC_H
 
+#include "stl_algobase.h"
+
 namespace ltx
 {
     // 将所有元素相加并加上初始值返回
@@ -21,6 +23,36 @@ namespace ltx
             init = binary_op(init, *first);
         return init;
     }
+
+    // 分段迭代器的版本, 每段是一个指针循环
+    template <typename SegmentedIterator, typename T>
+    T __segmented_accumulate(SegmentedIterator first, SegmentedIterator last, T init)
+    {
+        typedef segmented_iterator_traits<SegmentedIterator> traits;
+        typedef typename traits::segment_iterator segment_iterator;
+        typedef typename traits::local_iterator local_iterator;
+        __for_each_segment(first, last, [&](segment_iterator, local_iterator p, local_iterator q)
+        {
+            for(; p != q; ++p) init += *p;
+            return true;
+        });
+        return init;
+    }
+
+    template <typename SegmentedIterator, typename T, typename BinaryOperation>
+    T __segmented_accumulate(SegmentedIterator first, SegmentedIterator last, T init,
+                             BinaryOperation binary_op)
+    {
+        typedef segmented_iterator_traits<SegmentedIterator> traits;
+        typedef typename traits::segment_iterator segment_iterator;
+        typedef typename traits::local_iterator local_iterator;
+        __for_each_segment(first, last, [&](segment_iterator, local_iterator p, local_iterator q)
+        {
+            for(; p != q; ++p) init = binary_op(init, *p);
+            return true;
+        });
+        return init;
+    }
 }
 
 #endif
\ No newline at end of file
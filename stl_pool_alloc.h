@@ -0,0 +1,190 @@
+#ifndef STL_POOL_ALLOC_H
+#define STL_POOL_ALLOC_H
+
+#include <cstddef>
+#include <new>
+#include "stl_alloc.h"
+
+namespace ltx
+{
+    // 独立的内存池
+    // 结构和default_alloc相同(切分和补充free-list的操作见__pool_ops), 但free-list和内存池都保存在对象中,
+    // 不同的memory_pool互不干扰, 析构时把从堆中获取的空间全部归还
+    // 超过__MAX_BYTES的区块也由内存池记录, release时一并归还
+    class memory_pool
+    {
+    private:
+        static size_t FREELIST_INDEX(size_t bytes)
+        {
+            return size_class::index(bytes);
+        }
+
+        union obj
+        {
+            union obj * free_list_link;
+            char client_data[1];
+        };
+
+        // 从堆中获取的大块, 串成链表以便析构时归还
+        struct chunk_header
+        {
+            chunk_header * next;
+            size_t size;
+            char * data() { return (char*)(this+1); }
+        };
+
+        // 大区块前面的头部, 串成双向链表, 释放时可以直接摘下
+        struct alignas(std::max_align_t) large_header
+        {
+            large_header * prev;
+            large_header * next;
+            size_t size;
+        };
+
+        obj * free_list[__NFREELISTS];
+        char * start_free;
+        char * end_free;
+        size_t heap_size;
+        chunk_header * chunks;
+        large_header * large;
+        size_t large_bytes;
+
+        memory_pool(const memory_pool&);
+        memory_pool& operator=(const memory_pool&);
+
+    public:
+        memory_pool() : start_free(0), end_free(0), heap_size(0), chunks(0), large(0), large_bytes(0)
+        {
+            for(int i=0; i<__NFREELISTS; ++i) free_list[i] = nullptr;
+        }
+        ~memory_pool() { release(); }
+
+        // 默认的内存池, 默认构造的pool_alloc使用它
+        static memory_pool& default_pool()
+        {
+            static memory_pool pool;
+            return pool;
+        }
+
+        void * allocate(size_t n)
+        {
+            if(n > (size_t)__MAX_BYTES) return allocate_large(n);
+
+            size_t index = FREELIST_INDEX(n);
+            obj ** my_free_list = free_list + index;
+            obj * result = *my_free_list;
+            if(nullptr == result) return refill(size_class::size(index));
+            *my_free_list = result->free_list_link;
+            return result;
+        }
+
+        void deallocate(void * p, size_t n)
+        {
+            if(n > (size_t)__MAX_BYTES)
+            {
+                deallocate_large(p);
+                return ;
+            }
+            obj * q = (obj*) p;
+            obj ** my_free_list = free_list + FREELIST_INDEX(n);
+            q->free_list_link = *my_free_list;
+            *my_free_list = q;
+        }
+
+        // 归还内存池中所有的空间, 之前配置的区块全部失效
+        void release()
+        {
+            while(chunks != nullptr)
+            {
+                chunk_header * next = chunks->next;
+                ::operator delete(chunks);
+                chunks = next;
+            }
+            while(large != nullptr)
+            {
+                large_header * next = large->next;
+                base_alloc::deallocate(large, sizeof(large_header) + large->size);
+                large = next;
+            }
+            for(int i=0; i<__NFREELISTS; ++i) free_list[i] = nullptr;
+            start_free = end_free = 0;
+            heap_size = 0;
+            large_bytes = 0;
+        }
+
+        // 从堆中获取的字节数, 包括大区块
+        size_t bytes_reserved() const { return heap_size + large_bytes; }
+
+    private:
+        void * allocate_large(size_t n)
+        {
+            large_header * h = (large_header*) base_alloc::allocate(sizeof(large_header) + n);
+            h->prev = nullptr;
+            h->next = large;
+            h->size = n;
+            if(large != nullptr) large->prev = h;
+            large = h;
+            large_bytes += n;
+            return h + 1;
+        }
+
+        void deallocate_large(void * p)
+        {
+            large_header * h = (large_header*) p - 1;
+            if(h->prev != nullptr) h->prev->next = h->next;
+            else large = h->next;
+            if(h->next != nullptr) h->next->prev = h->prev;
+            large_bytes -= h->size;
+            base_alloc::deallocate(h, sizeof(large_header) + h->size);
+        }
+
+        void * refill(size_t n)
+        {
+            int nobjs = size_class::batch_limit(FREELIST_INDEX(n), 20);
+            char * chunk = chunk_alloc(n, nobjs);
+            if(nobjs > 1) __pool_ops::link_blocks(free_list[FREELIST_INDEX(n)], chunk+n, n, nobjs-1);
+            return chunk;
+        }
+
+        char * chunk_alloc(size_t size, int & nobjs)
+        {
+            char * result = __pool_ops::carve(start_free, end_free, size, nobjs);
+            if(result != nullptr) return result;
+
+            // 剩余的零头放到相应的free-list中, 再从堆中获取新的大块
+            size_t bytes_to_get = __pool_ops::chunk_bytes(size*nobjs, heap_size);
+            __pool_ops::spill(free_list, start_free, end_free);
+            chunk_header * c = (chunk_header*) ::operator new(sizeof(chunk_header) + bytes_to_get);
+            c->size = bytes_to_get;
+            c->next = chunks;
+            chunks = c;
+            heap_size += bytes_to_get;
+            start_free = c->data();
+            end_free = start_free + bytes_to_get;
+            return __pool_ops::carve(start_free, end_free, size, nobjs);
+        }
+    };
+
+    // 指向一个memory_pool的配置器, 作为容器的Alloc参数时保存在容器中
+    // 使不同容器可以使用不同的内存池, 默认构造时使用memory_pool::default_pool()
+    class pool_alloc
+    {
+    private:
+        memory_pool * pool;
+
+    public:
+        pool_alloc() : pool(&memory_pool::default_pool()) {}
+        pool_alloc(memory_pool & p) : pool(&p) {}
+
+        void * allocate(size_t n) { return pool->allocate(n); }
+        void deallocate(void * p, size_t n) { pool->deallocate(p, n); }
+
+        memory_pool & resource() const { return *pool; }
+
+        bool operator==(const pool_alloc & x) const { return pool == x.pool; }
+        bool operator!=(const pool_alloc & x) const { return pool != x.pool; }
+    };
+
+}
+
+#endif
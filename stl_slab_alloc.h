@@ -0,0 +1,149 @@
+#ifndef STL_SLAB_ALLOC_H
+#define STL_SLAB_ALLOC_H
+
+#include <cstddef>
+#include "stl_alloc.h"
+#include "stl_aligned_alloc.h"
+#include "memory.h"
+
+namespace ltx
+{
+    // 按类型划分的slab池
+    // 每种节点类型T独占一组按页对齐的slab, 节点在slab中连续存放, 释放的节点串在池自己的free-list上
+    // 这样同一容器的节点不会和其他类型的区块交错, 遍历时访问的缓存行和页更少
+    // slab从不归还, 和default_alloc的内存池一样
+    // slab从一段按页对齐的连续空间(run)中依次切出, run的页数从1开始加倍到__MAX_RUN_SLABS,
+    // 对齐的额外开销(最多一页)由一个run中的所有slab分摊, 不再是每个slab都多占一页
+    template <typename T>
+    class slab_pool
+    {
+    private:
+        union obj
+        {
+            union obj * free_list_link;
+            char client_data[1];
+        };
+
+        enum {__PAGE_SIZE = 4096};
+        enum {__OBJ_SIZE = sizeof(T) > sizeof(obj) ? sizeof(T) : sizeof(obj)};
+        enum {__MIN_OBJS = 8};      // 一个slab至少容纳的节点个数
+        // slab大小: 一页, 大节点时取能容纳__MIN_OBJS个节点的页数
+        enum {__SLAB_SIZE = __OBJ_SIZE*__MIN_OBJS <= __PAGE_SIZE ? __PAGE_SIZE
+            : (__OBJ_SIZE*__MIN_OBJS + __PAGE_SIZE - 1) / __PAGE_SIZE * __PAGE_SIZE};
+
+        static obj * free_list;
+        static char * cur;      // 当前slab中尚未切出的部分
+        static char * end;
+        static size_t nslabs;
+
+        enum {__MAX_RUN_SLABS = 16};
+        static char * run_cur;  // 当前run中尚未切出的slab
+        static char * run_end;
+        static size_t run_slabs;    // 下一个run包含的slab个数
+
+    public:
+        static T * allocate()
+        {
+            obj * result = free_list;
+            if(result != nullptr)
+            {
+                free_list = result->free_list_link;
+                return (T*) result;
+            }
+            if(size_t(end - cur) < (size_t)__OBJ_SIZE) new_slab();
+            char * p = cur;
+            cur += __OBJ_SIZE;
+            return (T*) p;
+        }
+
+        static void deallocate(T * p)
+        {
+            obj * q = (obj*) p;
+            q->free_list_link = free_list;
+            free_list = q;
+        }
+
+        // 已配置的slab个数和每个slab的字节数
+        static size_t slabs() { return nslabs; }
+        static size_t slab_size() { return __SLAB_SIZE; }
+
+    private:
+        // 当前slab剩下不足一个节点的零头直接丢弃
+        static void new_slab()
+        {
+            if(run_cur == run_end) new_run();
+            cur = run_cur;
+            run_cur += __SLAB_SIZE;
+            end = cur + __SLAB_SIZE;
+            ++nslabs;
+        }
+
+        static void new_run()
+        {
+            size_t n = run_slabs != 0 ? run_slabs : 1;
+            run_cur = (char*) align_alloc<>::allocate(n*__SLAB_SIZE, __PAGE_SIZE);
+            run_end = run_cur + n*__SLAB_SIZE;
+            run_slabs = n < (size_t)__MAX_RUN_SLABS ? 2*n : n;
+        }
+    };
+    // 定义和初始化类中的静态变量
+    template <typename T>
+    typename slab_pool<T>::obj * slab_pool<T>::free_list = nullptr;
+    template <typename T>
+    char * slab_pool<T>::cur = nullptr;
+    template <typename T>
+    char * slab_pool<T>::end = nullptr;
+    template <typename T>
+    size_t slab_pool<T>::nslabs = 0;
+    template <typename T>
+    char * slab_pool<T>::run_cur = nullptr;
+    template <typename T>
+    char * slab_pool<T>::run_end = nullptr;
+    template <typename T>
+    size_t slab_pool<T>::run_slabs = 0;
+
+    // slab配置器
+    // 作为容器的Alloc参数时, 单个节点(list, rb_tree的节点)从slab_pool<节点类型>配置,
+    // 数组(vector的缓冲区, deque的缓冲区和map)仍交给default_alloc
+    class slab_alloc
+    {
+    public:
+        static void * allocate(size_t n) { return default_alloc::allocate(n); }
+        static void deallocate(void * p, size_t n) { default_alloc::deallocate(p, n); }
+    };
+
+    template <typename T>
+    class simple_alloc<T, slab_alloc>
+    {
+    private:
+        typedef slab_alloc Alloc;
+
+    public:
+        static T * allocate(size_t n)
+        {
+            if(1==n) return slab_pool<T>::allocate();
+            return 0==n ? nullptr : (T*)default_alloc::allocate(n*sizeof(T));
+        }
+        static T * allocate(void)
+        {
+            return slab_pool<T>::allocate();
+        }
+        static void deallocate(T*p, size_t n)
+        {
+            if(1==n) slab_pool<T>::deallocate(p);
+            else if(0!=n) default_alloc::deallocate(p, n*sizeof(T));
+        }
+        static void deallocate(T *p)
+        {
+            slab_pool<T>::deallocate(p);
+        }
+
+        static T * allocate(Alloc &, size_t n) { return allocate(n); }
+        static T * allocate(Alloc &) { return allocate(); }
+        static void deallocate(Alloc &, T *p, size_t n) { deallocate(p, n); }
+        static void deallocate(Alloc &, T *p) { deallocate(p); }
+    };
+
+}
+
+#endif
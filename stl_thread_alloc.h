@@ -0,0 +1,268 @@
+#ifndef STL_THREAD_ALLOC_H
+#define STL_THREAD_ALLOC_H
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include "stl_alloc.h"
+
+namespace ltx
+{
+    // 多线程二级配置器
+    // 每个线程持有一组自己的free-list, allocate/deallocate的快速路径不加锁
+    // 线程缓存空了就从中心仓库取一批区块, 缓存过多就还一批给中心仓库
+    // 中心仓库每个free-list一把锁, 内存池另有一把锁, 只在批量交换时才会用到
+    class thread_alloc
+    {
+    private:
+        static size_t FREELIST_INDEX(size_t bytes)
+        {
+            return size_class::index(bytes);
+        }
+
+    private:
+        union obj
+        {
+            union obj * free_list_link;
+            char client_data[1];
+        };
+
+        // 线程与中心仓库之间每次交换的区块个数, 大区块按字节数减少
+        enum {__BATCH = 32};
+        static int batch_size(size_t index)
+        {
+            return size_class::batch_limit(index, __BATCH);
+        }
+
+        // 中心仓库中的一批区块, 以free_list_link串成一条以nullptr结尾的链
+        struct batch
+        {
+            obj * head;
+            size_t count;
+        };
+
+        // 中心仓库的一个free-list, 存放若干批区块
+        struct central_list
+        {
+            std::mutex lock;
+            batch * batches;
+            size_t nbatches;
+            size_t capacity;
+        };
+
+        // 中心仓库, 包含所有free-list和内存池
+        struct central
+        {
+            central_list lists[__NFREELISTS];
+
+            std::mutex pool_lock;
+            char * start_free;
+            char * end_free;
+            size_t heap_size;
+        };
+
+        // 线程缓存, 线程退出时把所有区块还给中心仓库
+        // 析构之后本线程的配置/释放(如其他thread_local的析构函数中)直接和中心仓库交换单个区块
+        struct thread_cache
+        {
+            obj * free_list[__NFREELISTS];
+            size_t count[__NFREELISTS];
+
+            thread_cache()
+            {
+                for(int i=0; i<__NFREELISTS; ++i)
+                {
+                    free_list[i] = nullptr;
+                    count[i] = 0;
+                }
+            }
+            ~thread_cache()
+            {
+                for(int i=0; i<__NFREELISTS; ++i)
+                {
+                    if(free_list[i] != nullptr)
+                        push_batch(i, free_list[i], count[i]);
+                }
+                destroyed() = true;
+            }
+        };
+
+        // 中心仓库永不析构, 避免进程退出时其他线程的缓存还在归还区块
+        static central & depot()
+        {
+            static central * c = new central();
+            return *c;
+        }
+
+        // 线程缓存已经析构, 平凡析构的thread_local在线程退出的整个过程中都可以读取
+        static bool & destroyed()
+        {
+            static thread_local bool d = false;
+            return d;
+        }
+
+        // 线程缓存已经析构时返回nullptr
+        static thread_cache * local()
+        {
+            if(destroyed()) return nullptr;
+            static thread_local thread_cache cache;
+            return &cache;
+        }
+
+    public:
+        static void * allocate(size_t n)
+        {
+            if(n > (size_t)__MAX_BYTES) return base_alloc::allocate(n);
+
+            thread_cache * ptc = local();
+            size_t index = FREELIST_INDEX(n);
+            if(nullptr == ptc) return allocate_uncached(index);
+            thread_cache & tc = *ptc;
+            obj * result = tc.free_list[index];
+            if(nullptr == result)
+            {
+                return refill(tc, size_class::size(index));
+            }
+            tc.free_list[index] = result->free_list_link;
+            --tc.count[index];
+            return result;
+        }
+
+        static void deallocate(void * p, size_t n)
+        {
+            if(n > (size_t)__MAX_BYTES)
+            {
+                base_alloc::deallocate(p, n);
+                return ;
+            }
+
+            thread_cache * ptc = local();
+            size_t index = FREELIST_INDEX(n);
+            obj * q = (obj*) p;
+            if(nullptr == ptc)
+            {
+                q->free_list_link = nullptr;
+                push_batch(index, q, 1);
+                return ;
+            }
+            thread_cache & tc = *ptc;
+            q->free_list_link = tc.free_list[index];
+            tc.free_list[index] = q;
+            // 本线程缓存的区块过多(比如生产者线程释放的都是消费者线程配置的区块)
+            // 还一批给中心仓库, 其他线程可以取走
+            if(++tc.count[index] >= (size_t)2*batch_size(index))
+                release(tc, index);
+        }
+
+    private:
+        // 线程缓存为空, 先从中心仓库取一批, 中心仓库也没有就从内存池切一批
+        static void * refill(thread_cache & tc, size_t n)
+        {
+            size_t index = FREELIST_INDEX(n);
+            batch b;
+            if(!pop_batch(index, b))
+            {
+                int nobjs = batch_size(index);
+                char * chunk = chunk_alloc(n, nobjs);
+                b.head = (obj*) chunk;
+                b.count = nobjs;
+                obj * current_obj = b.head;
+                for(int i=1; i<nobjs; ++i)
+                {
+                    current_obj->free_list_link = (obj*)(chunk + i*n);
+                    current_obj = current_obj->free_list_link;
+                }
+                current_obj->free_list_link = nullptr;
+            }
+            obj * result = b.head;
+            tc.free_list[index] = result->free_list_link;
+            tc.count[index] = b.count - 1;
+            return result;
+        }
+
+        // 没有线程缓存时只取一个区块, 同一批中其余的区块放回中心仓库
+        static void * allocate_uncached(size_t index)
+        {
+            batch b;
+            if(!pop_batch(index, b))
+            {
+                int nobjs = 1;
+                return chunk_alloc(size_class::size(index), nobjs);
+            }
+            if(b.count > 1) push_batch(index, b.head->free_list_link, b.count - 1);
+            return b.head;
+        }
+
+        // 从线程缓存摘下一批区块还给中心仓库
+        static void release(thread_cache & tc, size_t index)
+        {
+            int batch = batch_size(index);
+            obj * head = tc.free_list[index];
+            obj * tail = head;
+            for(int i=1; i<batch; ++i) tail = tail->free_list_link;
+            tc.free_list[index] = tail->free_list_link;
+            tc.count[index] -= batch;
+            tail->free_list_link = nullptr;
+            push_batch(index, head, batch);
+        }
+
+        static bool pop_batch(size_t index, batch & b)
+        {
+            central_list & cl = depot().lists[index];
+            std::lock_guard<std::mutex> guard(cl.lock);
+            if(cl.nbatches == 0) return false;
+            b = cl.batches[--cl.nbatches];
+            return true;
+        }
+
+        static void push_batch(size_t index, obj * head, size_t count)
+        {
+            central_list & cl = depot().lists[index];
+            std::lock_guard<std::mutex> guard(cl.lock);
+            if(cl.nbatches == cl.capacity)
+            {
+                // 批次数组满了, 扩充为两倍
+                size_t new_capacity = cl.capacity != 0 ? 2*cl.capacity : 16;
+                batch * new_batches = (batch*) base_alloc::allocate(new_capacity*sizeof(batch));
+                for(size_t i=0; i<cl.nbatches; ++i) new_batches[i] = cl.batches[i];
+                if(cl.batches != nullptr)
+                    base_alloc::deallocate(cl.batches, cl.capacity*sizeof(batch));
+                cl.batches = new_batches;
+                cl.capacity = new_capacity;
+            }
+            cl.batches[cl.nbatches].head = head;
+            cl.batches[cl.nbatches].count = count;
+            ++cl.nbatches;
+        }
+
+        // 与default_alloc::chunk_alloc相同, 但在pool_lock保护下进行
+        static char * chunk_alloc(size_t size, int & nobjs)
+        {
+            central & c = depot();
+            std::lock_guard<std::mutex> guard(c.pool_lock);
+
+            char * result = __pool_ops::carve(c.start_free, c.end_free, size, nobjs);
+            if(result != nullptr) return result;
+
+            size_t bytes_to_get = __pool_ops::chunk_bytes(size*nobjs, c.heap_size);
+            // 内存池剩余的零头按能放下的最大区块切分, 每块作为一批放入中心仓库
+            size_t bytes_left = c.end_free - c.start_free;
+            while(bytes_left > 0)
+            {
+                size_t index = size_class::index_floor(bytes_left);
+                obj * q = (obj*) c.start_free;
+                q->free_list_link = nullptr;
+                push_batch(index, q, 1);
+                c.start_free += size_class::size(index);
+                bytes_left -= size_class::size(index);
+            }
+            c.start_free = (char*) ::operator new(bytes_to_get);
+            c.heap_size += bytes_to_get;
+            c.end_free = c.start_free + bytes_to_get;
+            return __pool_ops::carve(c.start_free, c.end_free, size, nobjs);
+        }
+    };
+
+}
+
+#endif
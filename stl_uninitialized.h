@@ -1,10 +1,18 @@
 #ifndef STL_UNINITIALIZED_H
 #define STL_UNINITIALIZED_H
 
+#include <cstring>
 #include <type_traits>
 #include "stl_construct.h"
+#include "stl_algobase.h"
 namespace ltx
 {
+    // 可平凡搬迁: 把对象的字节复制到新位置, 并且不再析构原对象, 等价于移动构造后析构原对象
+    // 平凡可复制的类型自动满足; 其他类型(例如只持有一个指针的独占句柄)可以特化此模板声明满足
+    // 容器重新配置或后移元素时对这类元素使用memcpy/memmove
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
     template <typename InputIterator, typename ForwardIterator>
     ForwardIterator
     uninitialized_copy(InputIterator first, InputIterator last, ForwardIterator result)
@@ -16,15 +24,170 @@ namespace ltx
         }
         else 
         {
+            // commit or rollback: 某个元素构造失败时析构已构造的元素
             ForwardIterator cur = result;
-            for(; first!=last; ++first, ++cur)
+            try
             {
-                _construct(&*cur, *first);
+                for(; first!=last; ++first, ++cur)
+                {
+                    _construct(&*cur, *first);
+                }
+            }
+            catch(...)
+            {
+                _destroy(result, cur);
+                throw;
             }
             return cur;
         }
     }
 
+    // 把[first, last)中的元素移动构造到result开始的未初始化空间
+    template <typename InputIterator, typename ForwardIterator>
+    ForwardIterator
+    uninitialized_move(InputIterator first, InputIterator last, ForwardIterator result)
+    {
+        ForwardIterator cur = result;
+        for(; first!=last; ++first, ++cur)
+            _construct(&*cur, std::move(*first));
+        return cur;
+    }
+
+    // 重新配置空间时搬移元素
+    // 移动构造不会抛出异常(或者元素无法复制)时移动, 否则复制, 复制失败时析构已构造的元素
+    // 这样搬移失败时原空间中的元素保持不变
+    template <typename InputIterator, typename ForwardIterator>
+    ForwardIterator
+    __uninitialized_move_if_noexcept(InputIterator first, InputIterator last, ForwardIterator result, std::true_type)
+    {
+        return ltx::uninitialized_move(first, last, result);
+    }
+
+    template <typename InputIterator, typename ForwardIterator>
+    ForwardIterator
+    __uninitialized_move_if_noexcept(InputIterator first, InputIterator last, ForwardIterator result, std::false_type)
+    {
+        ForwardIterator cur = result;
+        try
+        {
+            for(; first!=last; ++first, ++cur)
+                _construct(&*cur, *first);
+        }
+        catch(...)
+        {
+            _destroy(result, cur);
+            throw;
+        }
+        return cur;
+    }
+
+    template <typename InputIterator, typename ForwardIterator>
+    inline ForwardIterator
+    uninitialized_move_if_noexcept(InputIterator first, InputIterator last, ForwardIterator result)
+    {
+        typedef typename std::remove_reference<decltype(*first)>::type T;
+        return __uninitialized_move_if_noexcept(first, last, result,
+            std::integral_constant<bool, std::is_nothrow_move_constructible<T>::value
+                                        || !std::is_copy_constructible<T>::value>());
+    }
+
+    // 复制一段连续空间, 元素可平凡复制且类型相同时用memmove, 否则逐个复制构造, 失败时析构已构造的元素
+    template <typename InputIterator, typename T>
+    inline T * __uninitialized_copy_span(InputIterator first, InputIterator last, T * result, std::true_type)
+    {
+        return __copy_span(first, last, result);
+    }
+
+    template <typename InputIterator, typename T>
+    inline T * __uninitialized_copy_span(InputIterator first, InputIterator last, T * result, std::false_type)
+    {
+        return __uninitialized_move_if_noexcept(first, last, result, std::false_type());
+    }
+
+    // 复制到分段迭代器指向的未初始化空间, 按目标的段拆分源区间
+    template <typename RandomAccessIterator, typename SegmentedIterator>
+    SegmentedIterator __uninitialized_copy_to_segmented(RandomAccessIterator first, RandomAccessIterator last,
+                                                        SegmentedIterator result)
+    {
+        typedef segmented_iterator_traits<SegmentedIterator> traits;
+        typedef typename std::remove_reference<decltype(*result)>::type T;
+        typedef typename std::remove_cv<typename std::remove_reference<decltype(*first)>::type>::type U;
+        typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value
+                                            && std::is_same<T, U>::value> trivial;
+        // 空区间不访问目标的段, 目标可能是没有缓冲区的空迭代器
+        if(first == last) return result;
+        typename traits::segment_iterator s = traits::segment(result);
+        typename traits::local_iterator l = traits::local(result);
+        SegmentedIterator cur = result;
+        try
+        {
+            for(;;)
+            {
+                ptrdiff_t room = traits::end(s) - l;
+                ptrdiff_t n = last - first;
+                if(n <= room) return traits::compose(s, __uninitialized_copy_span(first, last, l, trivial()));
+                __uninitialized_copy_span(first, first + room, l, trivial());
+                first += room;
+                ++s;
+                l = traits::begin(s);
+                cur = traits::compose(s, l);
+            }
+        }
+        catch(...)
+        {
+            _destroy(result, cur);
+            throw;
+        }
+    }
+
+    template <typename InputIterator, typename ForwardIterator>
+    inline ForwardIterator
+    __uninitialized_copy_from_segment(InputIterator first, InputIterator last, ForwardIterator result, std::false_type)
+    {
+        return ltx::uninitialized_copy(first, last, result);
+    }
+
+    template <typename InputIterator, typename T>
+    inline T * __uninitialized_copy_from_segment(InputIterator first, InputIterator last, T * result, std::false_type)
+    {
+        typedef typename std::remove_cv<typename std::remove_reference<decltype(*first)>::type>::type U;
+        return __uninitialized_copy_span(first, last, result,
+            std::integral_constant<bool, std::is_trivially_copyable<T>::value && std::is_same<T, U>::value>());
+    }
+
+    template <typename InputIterator, typename SegmentedIterator>
+    inline SegmentedIterator
+    __uninitialized_copy_from_segment(InputIterator first, InputIterator last, SegmentedIterator result, std::true_type)
+    {
+        return __uninitialized_copy_to_segmented(first, last, result);
+    }
+
+    // 从分段区间复制到未初始化空间, 每段是一次指针区间的复制; 失败时析构已构造的元素
+    template <typename SegmentedIterator, typename ForwardIterator>
+    ForwardIterator __segmented_uninitialized_copy(SegmentedIterator first, SegmentedIterator last,
+                                                   ForwardIterator result)
+    {
+        typedef segmented_iterator_traits<SegmentedIterator> traits;
+        typedef typename traits::segment_iterator segment_iterator;
+        typedef typename traits::local_iterator local_iterator;
+        typedef std::integral_constant<bool, segmented_iterator_traits<ForwardIterator>::is_segmented> segmented;
+        ForwardIterator cur = result;
+        try
+        {
+            __for_each_segment(first, last, [&](segment_iterator, local_iterator p, local_iterator q)
+            {
+                cur = __uninitialized_copy_from_segment(p, q, cur, segmented());
+                return true;
+            });
+        }
+        catch(...)
+        {
+            _destroy(result, cur);
+            throw;
+        }
+        return cur;
+    }
+
     template <typename InputIterator, typename ForwardIterator, typename T>
     inline void uninitialized_copy_fill(InputIterator first1, InputIterator last1,
                             ForwardIterator first2, ForwardIterator last2,
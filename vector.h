@@ -5,11 +5,46 @@
 #include "stl_iterator.h"
 
 #include <cstddef>
+#include <cstring>
+#include <utility>
+#include <algorithm>
 
 namespace ltx
 {
-    template <typename T, typename Alloc=alloc>
-    class vector
+    // vector的增长策略
+    // next_capacity(old_capacity, min_capacity, elem_size)返回重新配置时的新容量, 不小于min_capacity
+
+    // 容量按Num/Den倍增长, 至少增长1
+    template <size_t Num, size_t Den>
+    struct grow_by
+    {
+        static_assert(Num > Den, "growth factor must be greater than 1");
+        static size_t next_capacity(size_t old_capacity, size_t min_capacity, size_t)
+        {
+            size_t len = old_capacity + old_capacity/Den*(Num-Den) + old_capacity%Den*(Num-Den)/Den;
+            if(len <= old_capacity) len = old_capacity + 1;
+            return len < min_capacity ? min_capacity : len;
+        }
+    };
+    typedef grow_by<2, 1> grow_double;      // 2倍, 默认策略
+    typedef grow_by<3, 2> grow_one_half;    // 1.5倍, 峰值内存更小, 释放的旧空间更容易被后续重新配置复用
+
+    // 按Base增长, 缓冲区达到PageBytes后字节数上调至PageBytes的倍数, 使大缓冲区占满整页
+    template <typename Base = grow_one_half, size_t PageBytes = 4096>
+    struct grow_page
+    {
+        static size_t next_capacity(size_t old_capacity, size_t min_capacity, size_t elem_size)
+        {
+            size_t len = Base::next_capacity(old_capacity, min_capacity, elem_size);
+            size_t bytes = len*elem_size;
+            if(bytes >= PageBytes)
+                len = (bytes + PageBytes - 1) / PageBytes * PageBytes / elem_size;
+            return len;
+        }
+    };
+
+    template <typename T, typename Alloc=alloc, typename Grow=grow_double>
+    class vector : protected alloc_holder<Alloc>
     {
     public:
         typedef T               value_type;
@@ -26,46 +61,60 @@ namespace ltx
 
     protected:
         typedef simple_alloc<value_type, Alloc> data_allocator;
+        typedef alloc_holder<Alloc> alloc_base;
+        using alloc_base::get_alloc;
+
+        // 元素可平凡搬迁且配置器提供reallocate时, 重新配置直接调整原空间, 不再配置新空间再搬移
+        typedef std::integral_constant<bool, 
+            is_trivially_relocatable<T>::value && has_reallocate<Alloc>::value> use_reallocate;
 
         iterator start;
         iterator finish;
         iterator end_of_storage;
         
 
-        void insert_aux(iterator position, const T&x)
+        // 在position处以args构造新元素
+        template <typename... Args>
+        void insert_aux(iterator position, Args&&... args)
         {
             // 还有空间
             if(finish != end_of_storage)
             {
-                _construct(finish, *(finish-1));
-                ++finish;
-                T x_copy = x;
-                copy_backward(position, finish-2, finish-1);
-                *position = x_copy;
+                insert_in_place(position, is_trivially_relocatable<T>(), std::forward<Args>(args)...);
             }
             else  //没有空间
             {
-                const size_type old_size = size();
-                const size_type len = old_size!=0 ? 2*old_size : 1;
+                const size_type len = Grow::next_capacity(capacity(), size()+1, sizeof(T));
+                if(use_reallocate::value && start != nullptr)
+                {
+                    expand_insert(position, len, std::forward<Args>(args)...);
+                    return ;
+                }
                 
-                iterator new_start = data_allocator::allocate(len);
-                iterator new_finish = new_start;
+                iterator new_start = data_allocator::allocate(get_alloc(), len);
+                iterator new_finish;
+                // 先在新空间构造新元素, 此时args引用的旧元素仍然有效
+                iterator new_pos = new_start + (position - start);
                 try
                 {
-                    new_finish = uninitialized_copy(start, position, new_start);
-                    _construct(new_finish, x);
-                    ++new_finish;
-                    new_finish = uninitialized_copy(position, finish, new_finish);
-
+                    _construct(new_pos, std::forward<Args>(args)...);
                 }
                 catch(...)
                 {
-                    _destroy(new_start, new_finish);
-                    data_allocator::deallocate(new_start, len);
+                    data_allocator::deallocate(get_alloc(), new_start, len);
+                    throw;
+                }
+                try
+                {
+                    new_finish = relocate_to(position, new_start, 1);
+                }
+                catch(...)
+                {
+                    _destroy(new_pos);
+                    data_allocator::deallocate(get_alloc(), new_start, len);
                     throw;
                 }
 
-                _destroy(begin(), end());
                 deallocate();
                 
                 start = new_start;
@@ -76,10 +125,174 @@ namespace ltx
             }
         }
 
+        // 备用空间足够时在position处以args构造新元素, 之后的元素后移一位
+        // 可平凡搬迁的元素用一次memmove后移, 否则逐个移动
+        template <typename... Args>
+        void insert_in_place(iterator position, std::true_type, Args&&... args)
+        {
+            // args可能引用vector中的元素, 先构造出新元素再后移
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type buf;
+            _construct((T*)&buf, std::forward<Args>(args)...);
+            memmove((void*)(position+1), (const void*)position, (finish-position)*sizeof(T));
+            memcpy((void*)position, (const void*)&buf, sizeof(T));
+            ++finish;
+        }
+
+        template <typename... Args>
+        void insert_in_place(iterator position, std::false_type, Args&&... args)
+        {
+            T x_copy(std::forward<Args>(args)...);
+            _construct(finish, std::move(*(finish-1)));
+            ++finish;
+            std::move_backward(position, finish-2, finish-1);
+            *position = std::move(x_copy);
+        }
+
+        // 备用空间足够时在position处插入n个x
+        void fill_insert_in_place(iterator position, size_type n, const T& x, std::true_type)
+        {
+            const size_type elems_after = finish - position;
+            memmove((void*)(position+n), (const void*)position, elems_after*sizeof(T));
+            iterator cur = position;
+            try
+            {
+                for(; cur != position+n; ++cur) _construct(cur, x);
+            }
+            catch(...)
+            {
+                _destroy(position, cur);
+                memmove((void*)position, (const void*)(position+n), elems_after*sizeof(T));
+                throw;
+            }
+            finish += n;
+        }
+
+        void fill_insert_in_place(iterator position, size_type n, const T& x, std::false_type)
+        {
+            const size_type elems_after = finish - position;
+            iterator old_finish = finish;
+            // 插入点后的元素数量大于新增元素个数, 将原有元素中的后n个移动到未初始化的空间
+            // 剩余需要后移的元素使用move_backward, 之后直接使用fill填充新元素
+            if(elems_after > n)
+            {
+                ltx::uninitialized_move(finish-n, finish, finish);
+                finish += n;
+                std::move_backward(position, old_finish-n, old_finish);
+                fill(position, position+n, x);
+            }
+            else  
+            {
+                // 插入点后的元素小于等于新增元素个数
+                // 也是一样, 已经构造过得位置直接使用move和fill
+                // 没有构造过的位置使用uninitialized_move和uninitialized_fill_n
+                ltx::uninitialized_fill_n(finish, n-elems_after, x);
+                finish += n-elems_after;
+                ltx::uninitialized_move(position, old_finish, finish);
+                finish += elems_after;
+                fill(position, old_finish, x);
+            }
+        }
+
+        // 重新配置时把原有元素搬到new_start开始的新空间, 插入点之后的元素在新空间中后移gap个位置
+        // 返回新空间中的finish, 之后原空间中不再有需要析构的元素
+        // 失败时新空间中已构造的原有元素被析构, 原空间保持不变
+        iterator relocate_to(iterator position, iterator new_start, size_type gap)
+        {
+            return relocate_to(position, new_start, gap, is_trivially_relocatable<T>());
+        }
+
+        // 可平凡搬迁: 用memcpy整体复制, 不再析构原有元素
+        iterator relocate_to(iterator position, iterator new_start, size_type gap, std::true_type)
+        {
+            const size_type elems_before = position - start;
+            const size_type elems_after = finish - position;
+            if(elems_before != 0)
+                memcpy((void*)new_start, (const void*)start, elems_before*sizeof(T));
+            if(elems_after != 0)
+                memcpy((void*)(new_start+elems_before+gap), (const void*)position, elems_after*sizeof(T));
+            return new_start + elems_before + gap + elems_after;
+        }
+
+        // 否则能安全移动就移动, 不能就复制, 全部成功后再析构原有元素
+        iterator relocate_to(iterator position, iterator new_start, size_type gap, std::false_type)
+        {
+            iterator mid = ltx::uninitialized_move_if_noexcept(start, position, new_start);
+            iterator new_finish;
+            try
+            {
+                new_finish = ltx::uninitialized_move_if_noexcept(position, finish, mid+gap);
+            }
+            catch(...)
+            {
+                _destroy(new_start, mid);
+                throw;
+            }
+            _destroy(start, finish);
+            return new_finish;
+        }
+
+        // 用配置器的reallocate把空间调整为容量len, 原有元素按字节保留
+        void expand_storage(size_type len, std::true_type)
+        {
+            const size_type old_size = size();
+            start = data_allocator::reallocate(get_alloc(), start, capacity(), len);
+            finish = start + old_size;
+            end_of_storage = start + len;
+        }
+        void expand_storage(size_type, std::false_type) {}
+
+        // 没有空间时原地扩展到容量len, 再在position处以args构造新元素
+        template <typename... Args>
+        void expand_insert(iterator position, size_type len, Args&&... args)
+        {
+            // args可能引用vector中的元素, 先构造出新元素
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type buf;
+            _construct((T*)&buf, std::forward<Args>(args)...);
+            const size_type elems_before = position - start;
+            try
+            {
+                expand_storage(len, use_reallocate());
+            }
+            catch(...)
+            {
+                _destroy((T*)&buf);
+                throw;
+            }
+            position = start + elems_before;
+            memmove((void*)(position+1), (const void*)position, (finish-position)*sizeof(T));
+            memcpy((void*)position, (const void*)&buf, sizeof(T));
+            ++finish;
+        }
+
+        // 重新配置为容量为len的空间, 元素搬到新空间
+        void reallocate(size_type len)
+        {
+            if(use_reallocate::value && start != nullptr)
+            {
+                expand_storage(len, use_reallocate());
+                return ;
+            }
+            iterator new_start = data_allocator::allocate(get_alloc(), len);
+            iterator new_finish;
+            try
+            {
+                new_finish = relocate_to(finish, new_start, 0);
+            }
+            catch(...)
+            {
+                data_allocator::deallocate(get_alloc(), new_start, len);
+                throw;
+            }
+            deallocate();
+            start = new_start;
+            finish = new_finish;
+            end_of_storage = new_start + len;
+        }
+
         void deallocate()
         {
             if(start != nullptr) 
-                data_allocator::deallocate(start, end_of_storage-start);
+                data_allocator::deallocate(get_alloc(), start, end_of_storage-start);
         }
 
         void fill_initialize(size_type n, const T& value)
@@ -101,15 +314,51 @@ namespace ltx
         size_type size() const { return size_type(finish-start); }
         size_type capacity() const { return size_type(end_of_storage - start); }
         bool empty() const { return start==finish; }
+
+        // 预先配置至少能容纳n个元素的空间, 之后插入不超过n个元素时不再重新配置
+        void reserve(size_type n)
+        {
+            if(n > capacity()) reallocate(n);
+        }
+
+        // 释放多余的备用空间, 使capacity()等于size(), 释放的空间可以被配置器复用
+        void shrink_to_fit()
+        {
+            if(capacity() == size()) return ;
+            if(empty())
+            {
+                deallocate();
+                start = finish = end_of_storage = nullptr;
+            }
+            else reallocate(size());
+        }
         reference operator[](size_type n) { return *(begin()+n); }
 
         vector() :start(nullptr), finish(nullptr), end_of_storage(nullptr) {}
-        vector(size_type n, const T&value) { fill_initialize(n, value); }
-        vector(int n, const T& value) { fill_initialize(n, value); }
-        vector(long n, const T& value) { fill_initialize(n, value); }
-        explicit vector(size_type n) { fill_initialize(n, T()); }
-
+        explicit vector(const Alloc& a) 
+            :alloc_base(a), start(nullptr), finish(nullptr), end_of_storage(nullptr) {}
+        vector(size_type n, const T&value, const Alloc& a = Alloc()) 
+            :alloc_base(a) { fill_initialize(n, value); }
+        vector(int n, const T& value, const Alloc& a = Alloc()) 
+            :alloc_base(a) { fill_initialize(n, value); }
+        vector(long n, const T& value, const Alloc& a = Alloc()) 
+            :alloc_base(a) { fill_initialize(n, value); }
+        explicit vector(size_type n, const Alloc& a = Alloc()) 
+            :alloc_base(a) { fill_initialize(n, T()); }
+
+        // 复制和移动都会连同配置器一起传播
+        vector(const vector& x) :alloc_base(x.get_alloc())
+        {
+            start = allocate_and_copy(x.size(), x.begin(), x.end());
+            finish = start + x.size();
+            end_of_storage = finish;
+        }
 
+        vector(vector&& x) noexcept
+            :alloc_base(x.get_alloc()), start(x.start), finish(x.finish), end_of_storage(x.end_of_storage)
+        {
+            x.start = x.finish = x.end_of_storage = nullptr;
+        }
 
         ~vector()
         {
@@ -117,19 +366,63 @@ namespace ltx
             deallocate();
         }
 
-        vector<T, Alloc>& operator=(const vector<T, Alloc>& x) 
+        vector& operator=(const vector& x) 
         {
             if (&x == this) return *this;
-            if (x.size() > capacity()) 
+            // 配置器不同时先用原配置器释放全部空间, 再换成x的配置器
+            if (!this->same_alloc(x))
             {
+                clear();
                 deallocate();
-                resize(x.size());
+                start = finish = end_of_storage = nullptr;
+                get_alloc() = x.get_alloc();
+            }
+            const size_type xlen = x.size();
+            if (xlen > capacity()) 
+            {
+                iterator tmp = allocate_and_copy(xlen, x.begin(), x.end());
+                _destroy(start, finish);
+                deallocate();
+                start = tmp;
+                end_of_storage = start + xlen;
+            }
+            else if (size() >= xlen)
+            {
+                iterator i = copy(x.begin(), x.end(), begin());
+                _destroy(i, finish);
+            }
+            else 
+            {
+                copy(x.begin(), x.begin()+size(), start);
+                ltx::uninitialized_copy(x.begin()+size(), x.end(), finish);
             }
-            copy(x.begin(), x.end(), begin());
-            finish = begin() + difference_type(x.size());
+            finish = start + xlen;
+            return *this;
+        }
+
+        vector& operator=(vector&& x) noexcept
+        {
+            if (&x == this) return *this;
+            _destroy(start, finish);
+            deallocate();
+            get_alloc() = x.get_alloc();
+            start = x.start;
+            finish = x.finish;
+            end_of_storage = x.end_of_storage;
+            x.start = x.finish = x.end_of_storage = nullptr;
             return *this;
         }
 
+        void swap(vector& x) noexcept
+        {
+            std::swap(start, x.start);
+            std::swap(finish, x.finish);
+            std::swap(end_of_storage, x.end_of_storage);
+            this->swap_alloc(x);
+        }
+
+        Alloc get_allocator() const { return get_alloc(); }
+
         reference front() { return *begin(); }
         reference back() { return *(end()-1); }
         
@@ -145,6 +438,36 @@ namespace ltx
             }
             else insert_aux(end(), x);
         }
+        void push_back(T&& x) { emplace_back(std::move(x)); }
+
+        // 以args为参数在尾端直接构造元素
+        template <typename... Args>
+        void emplace_back(Args&&... args)
+        {
+            if(finish != end_of_storage)
+            {
+                _construct(finish, std::forward<Args>(args)...);
+                ++finish;
+            }
+            else insert_aux(end(), std::forward<Args>(args)...);
+        }
+
+        // 以args为参数在position处构造元素, 返回指向新元素的迭代器
+        template <typename... Args>
+        iterator emplace(iterator position, Args&&... args)
+        {
+            const size_type n = position - begin();
+            if(finish != end_of_storage && position == end())
+            {
+                _construct(finish, std::forward<Args>(args)...);
+                ++finish;
+            }
+            else insert_aux(position, std::forward<Args>(args)...);
+            return begin() + n;
+        }
+
+        iterator insert(iterator position, const T& x) { return emplace(position, x); }
+        iterator insert(iterator position, T&& x) { return emplace(position, std::move(x)); }
         void pop_back()
         {
             --finish;
@@ -153,14 +476,14 @@ namespace ltx
         iterator erase(iterator position)
         {
             if(position+1 != end())
-                copy(position+1, finish, position);
+                std::move(position+1, finish, position);
             --finish;
             _destroy(finish);
             return position;
         }   
 
         iterator erase(iterator first, iterator last) {
-            iterator i = copy(last, finish, first);
+            iterator i = std::move(last, finish, first);
             _destroy(i, finish);
             finish = finish - (last - first);
             return first;
@@ -176,6 +499,26 @@ namespace ltx
             else insert(end(), new_size-size(), x);
         }
         void resize(size_type new_size) { resize(new_size, T()); }
+
+        // 改变大小, 新增的元素默认初始化: 对平凡类型不写入任何值, 只移动finish
+        // 用于随后会被整体覆盖的缓冲区(例如read()的目标), 省去一遍清零和它带来的缺页
+        void resize_default_init(size_type new_size)
+        {
+            if(new_size < size()) erase(begin()+new_size, end());
+            else append_uninitialized(new_size - size());
+        }
+
+        // 在尾端追加n个默认初始化(平凡类型即未初始化)的元素, 返回指向第一个新元素的迭代器
+        iterator append_uninitialized(size_type n)
+        {
+            static_assert(std::is_trivially_default_constructible<T>::value,
+                "append_uninitialized requires a trivially default constructible type");
+            if(size_type(end_of_storage - finish) < n)
+                reallocate(Grow::next_capacity(capacity(), size()+n, sizeof(T)));
+            iterator result = finish;
+            finish += n;
+            return result;
+        }
         void clear() { erase(begin(), end()); }
 
         void insert(iterator position, size_type n, const T& x)
@@ -185,52 +528,47 @@ namespace ltx
                 // 备用空间足够
                 if(size_type(end_of_storage-finish) >= n)
                 {
+                    // x可能引用vector中的元素, 先复制一份
                     T x_copy = x;
-                    const size_type elems_after = finish - position;
-                    iterator old_finish = finish;
-                    // 插入点后的元素数量大于新增元素个数, 将原有元素中的后n个使用uninitial copy后移
-                    // 剩余需要后移的元素使用copy, 之后直接使用fill填充新元素
-                    if(elems_after > n)
-                    {
-                        uninitialized_copy(finish-n, finish, finish);
-                        finish += n;
-                        copy_backward(position, old_finish-n, old_finish);
-                        fill(position, position+n, x_copy);
-                    }
-                    else  
-                    {
-                        // 插入点后的元素小于等于新增元素个数
-                        // 也是一样, 已经构造过得位置直接使用copy和fill
-                        // 没有构造过的位置使用uninitial copy 和fill
-                        uninitialized_fill_n(finish, n-elems_after, x_copy);
-                        finish += n-elems_after;
-                        uninitialized_copy(position, old_finish, finish);
-                        finish += elems_after;
-                        fill(position, old_finish, x_copy);
-                    }
+                    fill_insert_in_place(position, n, x_copy, is_trivially_relocatable<T>());
                 }
                 else 
                 {
                     // 备用空间不足
-                    const size_type old_size = size();
-                    const size_t len = old_size + old_size>n ? old_size : n;
-                    // 新长度等于旧长度*2 或者 旧长度+n
-                    iterator new_start = data_allocator::allocate(len);
-                    iterator new_finish = new_start;
+                    // 新长度由增长策略决定, 至少为旧长度+n
+                    const size_type len = Grow::next_capacity(capacity(), size()+n, sizeof(T));
+                    if(use_reallocate::value && start != nullptr)
+                    {
+                        T x_copy = x;
+                        const size_type elems_before = position - start;
+                        expand_storage(len, use_reallocate());
+                        fill_insert_in_place(start + elems_before, n, x_copy, std::true_type());
+                        return ;
+                    }
+                    iterator new_start = data_allocator::allocate(get_alloc(), len);
+                    iterator new_finish;
+                    // 先填充新元素, 此时x引用的旧元素仍然有效
+                    iterator new_pos = new_start + (position - start);
+                    try
+                    {
+                        ltx::uninitialized_fill_n(new_pos, n, x);
+                    }
+                    catch(...)
+                    {
+                        data_allocator::deallocate(get_alloc(), new_start, len);
+                        throw;
+                    }
                     try
                     {
-                        new_finish = uninitialized_copy(start, position, new_start);
-                        new_finish = uninitialized_fill_n(new_finish, n, x);
-                        new_finish = uninitialized_copy(position, finish, new_finish);
+                        new_finish = relocate_to(position, new_start, n);
                     }
                     catch(...)
                     {
-                        _destroy(new_start, new_finish);
-                        data_allocator::deallocate(new_start, len);
+                        _destroy(new_pos, new_pos+n);
+                        data_allocator::deallocate(get_alloc(), new_start, len);
                         throw;
                     }
 
-                    _destroy(start, finish);
                     deallocate();
 
                     start = new_start;
@@ -244,11 +582,29 @@ namespace ltx
     protected:
         iterator allocate_and_fill(size_type n, const T&x)
         {
-            iterator result = (iterator) Alloc::allocate(n);
-            uninitialized_fill_n(result, n, x);
+            iterator result = data_allocator::allocate(get_alloc(), n);
+            ltx::uninitialized_fill_n(result, n, x);
+            return result;
+        }
+
+        template <typename ForwardIterator>
+        iterator allocate_and_copy(size_type n, ForwardIterator first, ForwardIterator last)
+        {
+            iterator result = data_allocator::allocate(get_alloc(), n);
+            try
+            {
+                ltx::uninitialized_copy(first, last, result);
+            }
+            catch(...)
+            {
+                data_allocator::deallocate(get_alloc(), result, n);
+                throw;
+            }
             return result;
         }
     };
 }
 
+#include "stl_bvector.h"
+
 #endif
\ No newline at end of file